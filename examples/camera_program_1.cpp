@@ -73,6 +73,7 @@ int main()
 
 	// stop all threads and disconnect the device.
 	cam.disconnect();
+	std::cout << "threads stopped and joined in " << cam.getStopLatency() << " ms\n";
 
 	return 1;
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+/*********************************************************************************
+created:	2026/10/18   10:12AM
+filename: 	semaphore_buffer_benchmark.cpp
+file base:	semaphore_buffer_benchmark
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	Benchmark that compares the frame handoff cost of the backends of
+fvkSemaphoreBuffer (mutex queue vs lock-free SPSC ring). A producer thread hands
+cv::Mat headers to a consumer thread, exactly like the camera and the processing
+threads do, no camera device is needed.
+
+usage:		semaphore_buffer_benchmark [number of frames] [capacity]
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkSemaphoreBuffer.h>
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+using namespace R3D;
+
+// hand over n frames from one thread to the other through a buffer with the given capacity.
+// with fvkBufferPolicy::Block every frame is delivered (camera thread is blocked while the buffer is full),
+// otherwise the frames are dropped according to the policy, like in the default camera mode.
+static void run(const fvkBufferBackend backend, const int n, const std::size_t capacity, const fvkBufferPolicy policy)
+{
+	fvkSemaphoreBuffer<cv::Mat> buffer(capacity, policy, backend);
+	const cv::Mat frame(480, 640, CV_8UC3);
+	const cv::Mat last(1, 1, CV_8UC1);	// end of stream marker.
+
+	auto received = 0;
+	const auto t0 = std::chrono::steady_clock::now();
+
+	std::thread consumer([&]()
+	{
+		while (true)
+		{
+			const auto f = buffer.get();
+			if (f.rows == 1)
+				break;
+			received++;
+		}
+	});
+
+	for (auto i = 0; i < n; i++)
+		buffer.put(frame);
+	buffer.put(last, true);
+
+	consumer.join();
+
+	const auto t = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+
+	const char* policies[] = { "DropNewest", "DropOldest", "Block     " };
+	std::cout << (backend == fvkBufferBackend::Queue ? "Queue   " : "SpscRing")
+		<< " " << policies[static_cast<int>(policy)]
+		<< " capacity: " << capacity
+		<< ", frames: " << n
+		<< ", delivered: " << received
+		<< ", ns/frame: " << (t / n)
+		<< ", frames/s: " << static_cast<long long>(n * 1e9 / t) << "\n";
+
+	const auto s = buffer.getStats();
+	std::cout << "         dropped: " << s.ndropped()
+		<< ", blocked puts: " << s.nblocked_puts
+		<< ", blocked gets: " << s.nblocked_gets
+		<< ", max occupancy: " << s.max_occupancy
+		<< ", get wait p50/p99: " << fvkBufferStats::percentile(s.get_wait, 50) << "/" << fvkBufferStats::percentile(s.get_wait, 99) << " us\n";
+}
+
+int main(int argc, char* argv[])
+{
+	const auto n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	const auto capacity = argc > 2 ? std::atoi(argv[2]) : 8;
+	if (n <= 0 || capacity <= 0)
+		return EXIT_FAILURE;
+
+	for (const auto policy : { fvkBufferPolicy::Block, fvkBufferPolicy::DropNewest, fvkBufferPolicy::DropOldest })
+	{
+		for (const std::size_t c : { std::size_t(1), static_cast<std::size_t>(capacity) })
+		{
+			run(fvkBufferBackend::Queue, n, c, policy);
+			run(fvkBufferBackend::SpscRing, n, c, policy);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/*********************************************************************************
+created:	2026/10/18   08:30PM
+filename: 	synthetic_camera_benchmark.cpp
+file base:	synthetic_camera_benchmark
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	Benchmark of the whole capture pipeline without a camera device.
+Several synthetic cameras (fvkCameraThreadSynthetic) generate a moving face at the
+given resolution with a simulated grab latency and jitter, the frames go through
+the buffer and the processing thread exactly like the frames of a real camera.
+The same seed gives the same frames and the same delays, so two runs can be compared.
+
+usage:		synthetic_camera_benchmark [cameras] [seconds] [width] [height] [latency ms] [jitter ms]
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkCamera.h>
+#include <fvk/camera/fvkCameraThreadSynthetic.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace R3D;
+
+int main(int argc, char* argv[])
+{
+	const auto ncameras = argc > 1 ? std::atoi(argv[1]) : 4;
+	const auto seconds = argc > 2 ? std::atoi(argv[2]) : 10;
+	const auto width = argc > 3 ? std::atoi(argv[3]) : 1280;
+	const auto height = argc > 4 ? std::atoi(argv[4]) : 720;
+	const auto latency = argc > 5 ? std::atof(argv[5]) : 5.0;
+	const auto jitter = argc > 6 ? std::atof(argv[6]) : 1.0;
+	if (ncameras <= 0 || seconds <= 0 || width <= 0 || height <= 0)
+		return EXIT_FAILURE;
+
+	std::vector<std::unique_ptr<fvkCamera>> cams;
+	for (auto i = 0; i < ncameras; i++)
+	{
+		auto ct = new fvkCameraThreadSynthetic(i, cv::Size(width, height), CV_8UC3, fvkSyntheticPattern::Face);
+		ct->setSeed(static_cast<unsigned>(i + 1));
+		ct->setLatency(latency, jitter);
+
+		std::unique_ptr<fvkCamera> cam(new fvkCamera(ct));
+		cam->setFrameRate(60);
+		if (!cam->connect() || !cam->start())
+		{
+			std::cout << "[" << i << "] could not start the synthetic camera.\n";
+			return EXIT_FAILURE;
+		}
+		cams.push_back(std::move(cam));
+	}
+
+	std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+	for (auto i = 0; i < ncameras; i++)
+	{
+		auto& cam = cams[i];
+		const auto fps = cam->getAvgFps();
+		const auto frames = cam->getFrameNumber();
+		const auto s = cam->getBufferStats();
+		cam->disconnect();
+
+		std::cout << "[" << i << "] " << width << "x" << height
+			<< " fps: " << fps
+			<< ", frames: " << frames
+			<< ", dropped: " << s.ndropped()
+			<< ", max occupancy: " << s.max_occupancy
+			<< ", get wait p50/p99: " << fvkBufferStats::percentile(s.get_wait, 50) << "/" << fvkBufferStats::percentile(s.get_wait, 99) << " us"
+			<< ", stop latency: " << cam->getStopLatency() << " ms\n";
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+#pragma once
+#ifndef fvkBroadcastBuffer_h__
+#define fvkBroadcastBuffer_h__
+
+/*********************************************************************************
+created:	2026/10/18   11:48AM
+filename: 	fvkBroadcastBuffer.h
+file base:	fvkBroadcastBuffer
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	fan-out buffer that hands every item put by one producer to any number
+of subscribers. Each subscriber has its own fvkSemaphoreBuffer with its own
+capacity and policy (lag policy), so a slow subscriber never steals frames from,
+or slows down, the other subscribers. The same item is shared by all the
+subscribers, for cv::Mat only the header is copied and the pixel data is shared
+through its reference count.
+
+usage example:
+--------------
+
+fvkBroadcastBuffer<cv::Mat> b;
+auto every = b.subscribe(8, fvkBufferPolicy::Block);			// every frame, producer waits for it.
+auto latest = b.subscribe(1, fvkBufferPolicy::DropOldest);	// only the most recent frame.
+b.put(frame);													// on the producer thread.
+auto f = latest->get();											// on any consumer thread.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkSemaphoreBuffer.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace R3D
+{
+
+template <typename _T>
+class FVK_CAMERA_EXPORT fvkBroadcastBuffer
+{
+public:
+	using Subscriber = std::shared_ptr<fvkSemaphoreBuffer<_T>>;
+
+	// Description:
+	// Default constructor that creates a buffer without any subscriber.
+	fvkBroadcastBuffer() :
+		m_list(std::make_shared<const std::vector<Subscriber>>())
+	{
+	}
+
+	// Description:
+	// Non-implemented.
+	fvkBroadcastBuffer(const fvkBroadcastBuffer&) = delete;
+	fvkBroadcastBuffer& operator=(const fvkBroadcastBuffer&) = delete;
+
+	// Description:
+	// Function to add a new subscriber that receives the items put after this call.
+	// capacity and policy are the lag policy of this subscriber, for example:
+	// (1, fvkBufferPolicy::DropOldest) receives only the latest item,
+	// (n, fvkBufferPolicy::DropNewest) receives every item as long as it keeps up with n items of lag,
+	// (n, fvkBufferPolicy::Block) receives every item, the producer waits for this subscriber.
+	// The returned buffer stays valid as long as it is referenced, even after unsubscribe().
+	auto subscribe(const std::size_t capacity = 1, const fvkBufferPolicy policy = fvkBufferPolicy::DropOldest, const fvkBufferBackend backend = fvkBufferBackend::Queue) -> Subscriber
+	{
+		auto s = std::make_shared<fvkSemaphoreBuffer<_T>>(capacity, policy, backend);
+
+		std::lock_guard<std::mutex> lk(m_mutex);
+		auto list = std::make_shared<std::vector<Subscriber>>(*m_list);
+		list->push_back(s);
+		m_list = list;
+		return s;
+	}
+	// Description:
+	// Function to remove a subscriber. It returns true on success.
+	auto unsubscribe(const Subscriber& s) -> bool
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		auto list = std::make_shared<std::vector<Subscriber>>(*m_list);
+		const auto it = std::find(list->begin(), list->end(), s);
+		if (it == list->end())
+			return false;
+		list->erase(it);
+		m_list = list;
+		return true;
+	}
+	// Description:
+	// Function to remove all the subscribers.
+	void clear()
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		m_list = std::make_shared<const std::vector<Subscriber>>();
+	}
+
+	// Description:
+	// Function to close the buffers of all the subscribers, so every consumer that waits
+	// for an item is woken up (see fvkSemaphoreBuffer::close()).
+	void close()
+	{
+		const auto list = subscribers();
+		for (const auto& s : *list)
+			s->close();
+	}
+	// Description:
+	// Function to open the buffers of all the subscribers again after close().
+	// The items that are in the buffers are discarded. A SpscRing subscriber is recreated,
+	// so its consumer must not use it during this call.
+	void reopen()
+	{
+		const auto list = subscribers();
+		for (const auto& s : *list)
+			s->reopen();
+	}
+
+	// Description:
+	// Function to hand the item to every subscriber according to its own policy.
+	// The subscriber list is copied on subscribe/unsubscribe, so this function only
+	// takes the mutex to get the current list and never while putting the item.
+	void put(const _T& item)
+	{
+		const auto list = subscribers();
+		for (const auto& s : *list)
+			s->put(item);
+	}
+	// Description:
+	// Function to hand the item to every subscriber, the last subscriber takes it over.
+	void put(_T&& item)
+	{
+		const auto list = subscribers();
+		const auto n = list->size();
+		for (std::size_t i = 0; i + 1 < n; i++)
+			(*list)[i]->put(item);
+		if (n > 0)
+			list->back()->put(std::move(item));
+	}
+
+	// Description:
+	// Function that returns the number of subscribers.
+	auto size() const -> std::size_t
+	{
+		return subscribers()->size();
+	}
+	// Description:
+	// Function that returns true if there is no subscriber.
+	auto empty() const -> bool
+	{
+		return subscribers()->empty();
+	}
+
+private:
+	auto subscribers() const -> std::shared_ptr<const std::vector<Subscriber>>
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		return m_list;
+	}
+
+	mutable std::mutex m_mutex;
+	std::shared_ptr<const std::vector<Subscriber>> m_list;
+};
+
+}
+
+#endif // fvkBroadcastBuffer_h__
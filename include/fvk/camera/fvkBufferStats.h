@@ -0,0 +1,253 @@
+#pragma once
+#ifndef fvkBufferStats_h__
+#define fvkBufferStats_h__
+
+/*********************************************************************************
+created:	2026/10/18   02:40PM
+filename: 	fvkBufferStats.h
+file base:	fvkBufferStats
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	statistics of a semaphore buffer (frames put, taken and dropped, how long
+put() and get() had to wait, and how full the buffer is).
+The counters are lock-free, the producer and the consumer only write to their own
+counters (on separate cache lines), and the clock is only read when a thread really
+has to wait, so the counters can stay enabled all the time.
+
+How to read them:
+a buffer that is mostly full, with dropped frames or blocked puts, means that the
+processing is the bottleneck. A buffer that is mostly empty, with long get() waits,
+means that the capturing is the bottleneck.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkBufferStats
+{
+public:
+	// number of buckets of the wait-time histograms.
+	// bucket 0 counts the waits shorter than 1 microsecond, bucket i counts the waits
+	// from 2^(i-1) to 2^i microseconds, and the last bucket counts all the longer waits.
+	static constexpr std::size_t nbuckets = 24;
+
+	fvkBufferStats() :
+		nputs(0),
+		ngets(0),
+		ndropped_newest(0),
+		ndropped_oldest(0),
+		nblocked_puts(0),
+		nblocked_gets(0),
+		occupancy(0),
+		max_occupancy(0),
+		capacity(0)
+	{
+		put_wait.fill(0);
+		get_wait.fill(0);
+	}
+
+	std::uint64_t nputs;				// number of items put into the buffer.
+	std::uint64_t ngets;				// number of items taken from the buffer.
+	std::uint64_t ndropped_newest;		// number of new items discarded because the buffer (or the frame pool) was full.
+	std::uint64_t ndropped_oldest;		// number of queued items replaced by (or discarded for) a newer item.
+	std::uint64_t nblocked_puts;		// number of times put() had to wait for a free slot.
+	std::uint64_t nblocked_gets;		// number of times get() (or getBatch()) had to wait for an item.
+	std::size_t occupancy;				// number of items in the buffer.
+	std::size_t max_occupancy;			// maximum number of items that were in the buffer.
+	std::size_t capacity;				// maximum number of items the buffer can hold.
+	std::array<std::uint64_t, nbuckets> put_wait;	// histogram of the put() waits.
+	std::array<std::uint64_t, nbuckets> get_wait;	// histogram of the get() waits.
+
+	// Description:
+	// Function that returns the total number of discarded items.
+	auto ndropped() const -> std::uint64_t { return ndropped_newest + ndropped_oldest; }
+
+	// Description:
+	// Function that returns the histogram bucket of a wait of the given nanoseconds.
+	static auto bucket(const long long nanoseconds) -> std::size_t
+	{
+		auto us = nanoseconds / 1000;
+		std::size_t i = 0;
+		while (us > 0 && i + 1 < nbuckets)
+		{
+			us >>= 1;
+			i++;
+		}
+		return i;
+	}
+	// Description:
+	// Function that returns the upper limit of the given histogram bucket in microseconds.
+	static auto bucketLimit(const std::size_t i) -> long long
+	{
+		return 1LL << i;
+	}
+	// Description:
+	// Function that returns the wait (upper limit in microseconds) that p percent (0 to 100)
+	// of the waits of the given histogram did not exceed, 0 if the histogram is empty.
+	static auto percentile(const std::array<std::uint64_t, nbuckets>& hist, const double p) -> long long
+	{
+		std::uint64_t total = 0;
+		for (const auto n : hist)
+			total += n;
+		if (total == 0)
+			return 0;
+
+		std::uint64_t sum = 0;
+		for (std::size_t i = 0; i < nbuckets; i++)
+		{
+			sum += hist[i];
+			if (sum * 100.0 >= p * total)
+				return bucketLimit(i);
+		}
+		return bucketLimit(nbuckets - 1);
+	}
+};
+
+// Description:
+// Lock-free counters that fvkSemaphoreBuffer updates, see fvkBufferStats.
+class FVK_CAMERA_EXPORT fvkBufferCounters
+{
+public:
+	fvkBufferCounters() { reset(); }
+
+	// Description:
+	// Non-implemented.
+	fvkBufferCounters(const fvkBufferCounters&) = delete;
+	fvkBufferCounters& operator=(const fvkBufferCounters&) = delete;
+
+	// Description:
+	// Function that returns the steady clock time in nanoseconds, to measure a wait.
+	static auto now() -> long long
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Description:
+	// Functions for the producer side.
+	void put(const bool replaced_oldest = false)
+	{
+		m_puts.fetch_add(1, std::memory_order_relaxed);
+		if (replaced_oldest)
+		{
+			m_dropped_oldest.fetch_add(1, std::memory_order_relaxed);
+			return;		// the number of items did not change.
+		}
+
+		const auto n = occupancy();
+		auto max = m_max_occupancy.load(std::memory_order_relaxed);
+		while (n > max && !m_max_occupancy.compare_exchange_weak(max, n, std::memory_order_relaxed)) {}
+	}
+	void dropNewest()
+	{
+		m_dropped_newest.fetch_add(1, std::memory_order_relaxed);
+	}
+	void dropOldest()
+	{
+		m_dropped_oldest.fetch_add(1, std::memory_order_relaxed);
+	}
+	void putWait(const long long start)
+	{
+		m_blocked_puts.fetch_add(1, std::memory_order_relaxed);
+		m_put_wait[fvkBufferStats::bucket(now() - start)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Description:
+	// Functions for the consumer side.
+	void get(const std::size_t n = 1)
+	{
+		m_gets.fetch_add(n, std::memory_order_relaxed);
+	}
+	void getWait(const long long start)
+	{
+		m_blocked_gets.fetch_add(1, std::memory_order_relaxed);
+		m_get_wait[fvkBufferStats::bucket(now() - start)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Description:
+	// Function that returns a copy of the counters.
+	auto snapshot(const std::size_t capacity) const -> fvkBufferStats
+	{
+		fvkBufferStats s;
+		s.nputs = m_puts.load(std::memory_order_relaxed);
+		s.ngets = m_gets.load(std::memory_order_relaxed);
+		s.ndropped_newest = m_dropped_newest.load(std::memory_order_relaxed);
+		s.ndropped_oldest = m_dropped_oldest.load(std::memory_order_relaxed);
+		s.nblocked_puts = m_blocked_puts.load(std::memory_order_relaxed);
+		s.nblocked_gets = m_blocked_gets.load(std::memory_order_relaxed);
+		s.occupancy = occupancy();
+		s.max_occupancy = m_max_occupancy.load(std::memory_order_relaxed);
+		s.capacity = capacity;
+		for (std::size_t i = 0; i < fvkBufferStats::nbuckets; i++)
+		{
+			s.put_wait[i] = m_put_wait[i].load(std::memory_order_relaxed);
+			s.get_wait[i] = m_get_wait[i].load(std::memory_order_relaxed);
+		}
+		// the counters of both sides are not read at the same instant.
+		if (s.occupancy > capacity) s.occupancy = capacity;
+		if (s.max_occupancy > capacity) s.max_occupancy = capacity;
+		return s;
+	}
+
+	// Description:
+	// Function that sets all the counters to zero.
+	// It should only be called when no thread uses the buffer.
+	void reset()
+	{
+		m_puts = 0;
+		m_dropped_newest = 0;
+		m_dropped_oldest = 0;
+		m_blocked_puts = 0;
+		m_max_occupancy = 0;
+		m_gets = 0;
+		m_blocked_gets = 0;
+		for (std::size_t i = 0; i < fvkBufferStats::nbuckets; i++)
+		{
+			m_put_wait[i] = 0;
+			m_get_wait[i] = 0;
+		}
+	}
+
+private:
+	// the items that are in the buffer are the ones put, minus the ones replaced or taken.
+	auto occupancy() const -> std::size_t
+	{
+		const auto in = m_puts.load(std::memory_order_relaxed) - m_dropped_oldest.load(std::memory_order_relaxed);
+		const auto out = m_gets.load(std::memory_order_relaxed);
+		return in > out ? static_cast<std::size_t>(in - out) : 0;
+	}
+
+	// producer side.
+	alignas(64) std::atomic<std::uint64_t> m_puts;
+	std::atomic<std::uint64_t> m_dropped_newest;
+	std::atomic<std::uint64_t> m_dropped_oldest;
+	std::atomic<std::uint64_t> m_blocked_puts;
+	std::atomic<std::size_t> m_max_occupancy;
+	std::array<std::atomic<std::uint64_t>, fvkBufferStats::nbuckets> m_put_wait;
+
+	// consumer side.
+	alignas(64) std::atomic<std::uint64_t> m_gets;
+	std::atomic<std::uint64_t> m_blocked_gets;
+	std::array<std::atomic<std::uint64_t>, fvkBufferStats::nbuckets> m_get_wait;
+};
+
+}
+
+#endif // fvkBufferStats_h__
@@ -27,6 +27,10 @@ Both threads are synchronized with semaphore methodology.
 
 #include "fvkCameraThreadOpenCV.h"
 #include "fvkProcessingThread.h"
+#include "fvkExecutor.h"
+#include "fvkFrameStream.h"
+#include "fvkJThread.h"
+#include "fvkWatchdog.h"
 #include <thread>
 
 namespace R3D
@@ -43,6 +47,10 @@ public:
 	// Virtual function that is expected to be overridden in the derived class in order
 	// to process the captured frame.
 	virtual void present(cv::Mat& frame) = 0;
+	// Description:
+	// Virtual function that can be overridden in order to process the captured frame together
+	// with its capture information (see fvkFrame). By default, it calls present() with the image.
+	virtual void present(fvkFrame& frame) { present(frame.image); }
 };
 
 class FVK_CAMERA_EXPORT fvkCamera : public fvkCameraAbstract
@@ -94,11 +102,23 @@ public:
 	// It returns true on success.
 	auto start() -> bool;
 	// Description:
+	// Function that starts the camera like start(), but the capturing and the processing
+	// are executed as tasks on the given executor instead of two dedicated threads,
+	// one iteration at a time (see fvkThreadTask). Many cameras can share one executor.
+	// The executor must outlive disconnect(). The thread handles are not set in this mode.
+	// It returns true on success.
+	auto start(fvkExecutor& executor) -> bool;
+	// Description:
 	// Function to disconnect the camera device or if the video file is specified,
 	// then close the video file.
-	// It terminates the camera as well as the processing threads.
+	// It terminates the camera as well as the processing threads, and returns
+	// once both threads have been joined.
 	// It returns true on success.
 	auto disconnect() -> bool;
+	// Description:
+	// Function that returns the time in milliseconds that the last disconnect() took from
+	// the stop request until both threads were joined.
+	auto getStopLatency() const -> double { return m_stop_latency; }
 
 	// Description:
 	// Function to set the camera device index.
@@ -133,6 +153,39 @@ public:
 	// Function to get the frame delay.
 	// Default delay for video files is computed by (1000.0 / getFps()). (only for videos)
 	auto getDelay() const -> int;
+	// Description:
+	// Function to set the frame delay as a capturing rate in frames per second,
+	// with a resolution below one millisecond (setFrameRate(30) gives 33.333 milliseconds).
+	void setFrameRate(const double fps) const;
+	// Description:
+	// Function to get the capturing rate of the camera thread in frames per second.
+	auto getFrameRate() const -> double;
+	// Description:
+	// Function to set how the camera thread keeps its rate when grabbing a frame takes time.
+	// Default is fvkPacing::CatchUp (see fvkThread::setPacing()).
+	void setPacing(const fvkPacing pacing) const;
+	// Description:
+	// Function to get how the camera thread keeps its rate.
+	auto getPacing() const -> fvkPacing;
+
+	// Description:
+	// Functions to pin the camera (capturing) and the processing threads to the given CPU cores,
+	// for example to keep the capturing on dedicated cores and the processing away from the cores
+	// that handle the interrupts. An empty list allows all the cores (see fvkThread::setAffinity()).
+	// They can be called before or after the start() function.
+	void setCamThreadAffinity(const std::vector<int>& cpus) const;
+	void setProcThreadAffinity(const std::vector<int>& cpus) const;
+	// Description:
+	// Functions to set the scheduling policy and priority of the camera and the processing threads,
+	// for example (fvkSchedPolicy::Fifo, 50) for the capturing, (fvkSchedPolicy::Other, 5) for a
+	// processing that may be slowed down (see fvkSchedPolicy).
+	void setCamThreadScheduling(const fvkSchedPolicy policy, const int priority) const;
+	void setProcThreadScheduling(const fvkSchedPolicy policy, const int priority) const;
+	// Description:
+	// Functions to set the names of the camera and the processing threads.
+	// Default names are "fvk-cap-<index>" and "fvk-proc-<index>".
+	void setCamThreadName(const std::string& name) const;
+	void setProcThreadName(const std::string& name) const;
 
 	// Description:
 	// Function to enable the perfect synchronization between the processing thread and the camera thread.
@@ -142,10 +195,130 @@ public:
 	// Function that returns true if the perfect synchronization is enabled.
 	auto isSyncEnabled() const -> bool;
 
+	// Description:
+	// Function to select the storage backend of the buffer between the camera and the processing threads.
+	// fvkBufferBackend::SpscRing is a lock-free ring that only parks a thread when it is really empty or full,
+	// it requires that frames are only taken by the processing thread (use subscribe() for the other consumers),
+	// so it is refused when several workers are set (see setWorkerCount()).
+	// This should be called before calling the start() function.
+	void setBufferBackend(const fvkBufferBackend backend) const;
+	// Description:
+	// Function to get the storage backend of the buffer between the camera and the processing threads.
+	auto getBufferBackend() const -> fvkBufferBackend;
+	// Description:
+	// Function to set the number of frames that can be in flight between the camera and the processing threads.
+	// A deeper buffer absorbs processing jitter without stalling the capturing.
+	// The frame pool is enlarged if it can not hold the frames in flight.
+	// Default capacity is 1. This should be called before calling the start() function.
+	void setBufferCapacity(const std::size_t capacity) const;
+	// Description:
+	// Function to get the number of frames that can be in flight between the camera and the processing threads.
+	auto getBufferCapacity() const -> std::size_t;
+	// Description:
+	// Function to set what happens to a grabbed frame when the buffer is full.
+	// fvkBufferPolicy::DropNewest discards the new frame (default).
+	// fvkBufferPolicy::DropOldest discards the oldest frame, so the processing thread always gets the freshest frame.
+	// fvkBufferPolicy::Block blocks the camera thread until the processing thread takes a frame.
+	// If the synchronization is enabled by setSyncEnabled(true), the camera thread always blocks.
+	void setBufferPolicy(const fvkBufferPolicy policy) const;
+	// Description:
+	// Function to get what happens to a grabbed frame when the buffer is full.
+	auto getBufferPolicy() const -> fvkBufferPolicy;
+	// Description:
+	// Function to set what the camera thread does when the processing is slower than the capturing.
+	// fvkBackpressure::None keeps grabbing at the frame rate (default).
+	// fvkBackpressure::Throttle lowers the grab rate to the processing rate, and raises it again when the processing catches up.
+	// fvkBackpressure::Skip only grabs the frames that the buffer would drop, without decoding nor copying them.
+	void setBackpressure(const fvkBackpressure policy) const;
+	// Description:
+	// Function to get what the camera thread does when the processing is slower than the capturing.
+	auto getBackpressure() const -> fvkBackpressure;
+	// Description:
+	// Function to get the statistics of the buffer between the camera and the processing threads
+	// (frames put, taken and dropped, wait times of both threads and occupancy).
+	// A full buffer with dropped frames means that the processing is the bottleneck,
+	// an empty buffer with long waits of the processing thread means that the capturing is the bottleneck.
+	auto getBufferStats() const -> fvkBufferStats;
+	// Description:
+	// Function to set the statistics of the buffer to zero.
+	// This should be called before calling the start() function.
+	void resetBufferStats() const;
+
+	// Description:
+	// Function to set the number of frames that the processing thread processes together (batch mode).
+	// The processing thread takes up to n frames at once and hands them to presentBatch(),
+	// it waits for at most the given milliseconds for a full batch.
+	// The buffer capacity is enlarged to n if it is smaller.
+	// Default is 1 (no batch mode). This should be called before calling the start() function.
+	void setBatchSize(const std::size_t n, const unsigned long milliseconds = 100) const;
+	// Description:
+	// Function to get the number of frames that the processing thread processes together.
+	auto getBatchSize() const -> std::size_t;
+	// Description:
+	// Function to set the number of workers that process the frames of this camera at the same time.
+	// The processed frames are put back in the captured order before present(), the video output
+	// and the recording (see fvkProcessingThread::setWorkerCount()). Several workers need the
+	// fvkBufferBackend::Queue backend of the buffer, they are refused with fvkBufferBackend::SpscRing.
+	// Default is 1. This should be called before calling the start() function.
+	void setWorkerCount(const std::size_t n) const;
+	// Description:
+	// Function to get the number of workers that process the frames of this camera at the same time.
+	auto getWorkerCount() const -> std::size_t;
+
 	// Description:
 	// Function to get the current grabbed frame.
+	// It waits for the next grabbed frame, and it does not take frames away from the processing thread.
+	// The frame is a private copy, it can be modified and kept by the caller.
 	auto getFrame() const -> cv::Mat;
 
+	// Description:
+	// Function to add a frame consumer (recorder, display, analytics, ...) that receives the grabbed frames
+	// independently of the processing thread and of the other consumers.
+	// capacity and policy are the lag policy of this consumer, for example:
+	// subscribe(1, fvkBufferPolicy::DropOldest) receives only the latest frame,
+	// subscribe(8, fvkBufferPolicy::DropNewest) receives every frame as long as it keeps up with 8 frames of lag,
+	// subscribe(8, fvkBufferPolicy::Block) receives every frame, but the camera thread waits for this consumer.
+	// All the consumers share the same frame data (read-only), no copy is made per consumer.
+	// Call get() on the returned buffer from the consumer thread.
+	auto subscribe(const std::size_t capacity = 1, const fvkBufferPolicy policy = fvkBufferPolicy::DropOldest) const -> fvkBroadcastBuffer<fvkFrame>::Subscriber;
+	// Description:
+	// Function to remove a frame consumer that was added by subscribe().
+	auto unsubscribe(const fvkBroadcastBuffer<fvkFrame>::Subscriber& s) const -> bool;
+	// Description:
+	// Function to add a frame consumer that receives the grabbed frames asynchronously on an
+	// executor of its choice instead of a blocking thread (see fvkFrameStream).
+	// capacity and policy are the lag policy of this consumer, like in subscribe().
+	// Call unsubscribe(stream.buffer()) to remove it.
+	auto frameStream(const std::size_t capacity = 1, const fvkBufferPolicy policy = fvkBufferPolicy::DropOldest) const -> fvkFrameStream;
+	// Description:
+	// Function to get the stream of the latest grabbed frames that is used by nextFrame().
+	// It is created by the first call, and it gets a copy of every grabbed frame until it is
+	// released by resetFrameStream() (or unsubscribe(getFrameStream().buffer())).
+	auto getFrameStream() const -> fvkFrameStream;
+	// Description:
+	// Function to release the stream of nextFrame(), so the grabbed frames are not handed to it
+	// anymore. A coroutine that awaits it gets an empty frame, the next call to nextFrame() creates
+	// a new stream. It returns false if there is no stream.
+	auto resetFrameStream() const -> bool;
+	// Description:
+	// Function that returns an awaitable of the next grabbed frame (C++20 coroutines),
+	// co_await cam.nextFrame(executor) resumes the coroutine on a worker of the executor.
+	// An empty frame means that the camera has been disconnected.
+	// Only one coroutine should await it at a time, use frameStream() for more consumers.
+	auto nextFrame(fvkExecutor& executor) const -> fvkFrameAwaiter { return getFrameStream().next(executor); }
+	auto nextFrame(fvkPostFunc post) const -> fvkFrameAwaiter { return getFrameStream().next(std::move(post)); }
+
+	// Description:
+	// Function to let the watchdog watch the camera and the processing threads of this camera.
+	// The stalls of both threads (for example, a grab() that hangs) are reported to f, the stalled
+	// thread is not interrupted: a grab() that never returns can not be recovered from another thread.
+	// f can call fvkCameraThread::requestReopen(), which reopens the device once grab() has returned. The threads are unwatched by the destructor, through the
+	// watchdog, so the watchdog must outlive this camera (or unwatch() must be called before).
+	void watch(fvkWatchdog& watchdog, const std::chrono::milliseconds& timeout, fvkStallFunc f = nullptr);
+	// Description:
+	// Function to stop watching the threads of this camera.
+	void unwatch();
+
 	// Description:
 	// Function that returns the average frames per second of the processing thread.
 	auto getAvgFps() const -> int;
@@ -158,7 +331,22 @@ public:
 	// The display function should be capable of handling multi-threading updating.
 	// The second argument which is fvkThreadStats will give you statistics of the Processing thread,
 	// such as Average frames per second (FPS) and number of processed frames.
+	// The frame comes with its capture time, sequence number and camera index (see fvkFrame),
+	// so the latency from the capture to the output is frame.age().
+	void setVideoOutput(const std::function<void(fvkFrame&, const fvkThreadStats&)> f) const;
+	// Description:
+	// Set a GUI function to display the processed frame, it only gets the image of the frame.
 	void setVideoOutput(const std::function<void(cv::Mat&, const fvkThreadStats&)> f) const;
+	// Description:
+	// Function to get the most recently processed frame without blocking (wait-free).
+	// Unlike setVideoOutput(), the GUI reads at its own refresh rate and painting never
+	// slows down the processing thread, and the newest frame is always shown.
+	// Only one (GUI) thread should call this function.
+	// It returns true if a new frame has been processed since the last call.
+	// Example (in a GUI timer):
+	// cv::Mat m;
+	// if (cam.getLatestFrame(m)) cv::imshow("FVK Camera", m);
+	auto getLatestFrame(cv::Mat& frame) const -> bool;
 
 	// Description:
 	// Function that saves the current image frame
@@ -221,6 +409,10 @@ public:
 	// Function to get a reference to image processing.
 	// It is a helper shortcut function to "cam->getProcThread()->imageProcessing()".
 	auto& imageProcessing() { return p_pt->imageProcessing(); }
+	// Description:
+	// Function to get a reference to the pool of the recycled frame buffers.
+	// It is a helper shortcut function to "cam->getCamThread()->framePool()".
+	auto& framePool() { return p_ct->framePool(); }
 
 	// Description:
 	// Function to get a pointer to camera/capturing thread.
@@ -230,10 +422,12 @@ public:
 	auto getProcThread() const { return p_pt; }
 
 	// Description:
-	// Function to get a pointer to camera/capturing thread handle.
+	// Function to get the native handle of the camera/capturing thread.
+	// It is valid from start() until disconnect().
 	auto getCamThreadHandle() const { return m_ct_handle; }
 	// Description:
-	// Function to get a pointer to camera/frame processing thread handle.
+	// Function to get the native handle of the camera/frame processing thread.
+	// It is valid from start() until disconnect().
 	auto getProcThreadHandle() const { return m_pt_handle; }
 
 protected:
@@ -241,14 +435,37 @@ protected:
 	// Virtual function that is expected to be overridden in the derived class in order
 	// to process the captured frame.
 	void present(cv::Mat& frame) override;
+	using fvkCameraAbstract::present;
+	// Description:
+	// Function that checks the device and prepares the buffers and the stop source of a new run.
+	auto prepareStart() -> bool;
+	// Description:
+	// Function that enlarges the frame pools of the camera thread and of the filters, so they can hold
+	// all the frames in flight (buffer, processing, display and mailbox, see fvkCameraThread::framePool()
+	// and fvkImageProcessing::framePool()).
+	void reserveFrames() const;
+	// Description:
+	// Function that requests the stop of both threads and joins them.
+	void joinThreads();
+	// Description:
+	// Functions that wait until the camera (or the processing) thread or task has left.
+	void joinCamThread();
+	void joinProcThread();
 
 	fvkCameraThread* p_ct;			// camera runs on capturing thread.
 	fvkProcessingThread* p_pt;		// captured frame processing runs on processing thread.
 
-	std::thread* p_stdct;			// thread for capturing device.
-	std::thread* p_stdpt;			// thread for captured frame processing.
-	void* m_ct_handle;				// native handle for capturing thread.
-	void* m_pt_handle;				// native handle for processing thread.
+	fvkStopSource m_stop;			// stops both threads of the current run.
+	fvkJThread m_ct_thread;			// thread for capturing device.
+	fvkJThread m_pt_thread;			// thread for captured frame processing.
+	std::shared_ptr<fvkThreadTask> m_ct_task;	// capturing task, when started on an executor.
+	std::shared_ptr<fvkThreadTask> m_pt_task;	// processing task, when started on an executor.
+	std::thread::native_handle_type m_ct_handle;	// native handle for capturing thread.
+	std::thread::native_handle_type m_pt_handle;	// native handle for processing thread.
+	double m_stop_latency;			// milliseconds from the stop request until both threads were joined.
+	fvkWatchdog* p_watchdog;		// watchdog that watches the threads of this camera.
+	mutable std::mutex m_streammutex;
+	mutable fvkFrameStream m_framestream;	// stream of the latest frames for nextFrame().
 };
 
 }
@@ -12,7 +12,10 @@ website:    http://real3d.pk
 CopyRight:	All Rights Reserved
 
 purpose:	class that gives a list of camera devices with add, remove, and
-find features.
+find features. All the cameras of the list can be started on one shared executor,
+so they run on a fixed number of threads (one per core) instead of two threads per camera.
+The cameras of the list can also grab their frames at the same instant (see fvkGrabGroup),
+for the multi-camera setups that need time-aligned frame sets.
 
 /**********************************************************************************
 *	Fast Visualization Kit (FVK)
@@ -24,11 +27,15 @@ find features.
 **********************************************************************************/
 
 #include "fvkCameraExport.h"
+#include "fvkExecutor.h"
+#include "fvkGrabGroup.h"
 
 #include <opencv2/opencv.hpp>
 
 #include <vector>
 #include <algorithm>
+#include <iostream>
+#include <memory>
 
 namespace R3D
 {
@@ -202,6 +209,115 @@ public:
 		return remove(getByIndex(device_index));
 	}
 
+	// Description:
+	// Function to enable (true) or disable (false) the executor mode, in which start() runs the
+	// capturing and the processing of all the cameras as tasks on one work-stealing executor with
+	// the given number of threads (0 means one thread per core), see fvkExecutor.
+	// Every camera takes turns with one iteration at a time, so a fast camera does not starve the others.
+	// A camera that grabs from a device still occupies a thread while it waits for the device.
+	// The executor is replaced (or destroyed) by this call, so it is refused and returns false
+	// while a camera of the list is running, disconnect() them first. It returns true on success.
+	auto setExecutorEnabled(const bool b, const std::size_t nthreads = 0)
+	{
+		if (isRunning())
+		{
+			std::cout << "the executor mode can not be changed while the cameras are running.\n";
+			return false;
+		}
+
+		if (b)
+			m_executor.reset(new fvkExecutor(nthreads));
+		else
+			m_executor.reset();
+		return true;
+	}
+	// Description:
+	// Function that returns true if the executor mode is enabled.
+	auto isExecutorEnabled() const { return m_executor != nullptr; }
+	// Description:
+	// Function to get a pointer to the executor, nullptr if the executor mode is disabled.
+	auto getExecutor() const { return m_executor.get(); }
+
+	// Description:
+	// Function to enable (true) or disable (false) the synchronized grab, in which all the cameras
+	// of the list latch their frames at the same instant and decode them afterwards in parallel,
+	// and the frames of the same grab are delivered together as a frame set (see fvkGrabGroup).
+	// A camera thread that does not override latch() and retrieve() decodes its frame while the others wait.
+	// The cameras wait for each other, so they run on their own threads even if the executor mode is enabled.
+	// The running camera threads refer to the group and have joined it when they started, so this call
+	// is refused and returns false while a camera of the list is running, disconnect() them first.
+	// It returns true on success.
+	auto setGrabSyncEnabled(const bool b)
+	{
+		if (isRunning())
+		{
+			std::cout << "the synchronized grab can not be changed while the cameras are running.\n";
+			return false;
+		}
+
+		if (b)
+			m_group.reset(new fvkGrabGroup());
+		else
+			m_group.reset();
+
+		for (auto& cam : m_list)
+		{
+			if (cam->getCamThread())
+				cam->getCamThread()->setGrabGroup(m_group.get());
+		}
+		return true;
+	}
+	// Description:
+	// Function that returns true if the synchronized grab is enabled.
+	auto isGrabSyncEnabled() const { return m_group != nullptr; }
+	// Description:
+	// Function to get a pointer to the group of the synchronized grab, nullptr if it is disabled.
+	// Its frame set output receives the time-aligned frames of all the cameras.
+	auto getGrabGroup() const { return m_group.get(); }
+
+	// Description:
+	// Function that starts all the cameras of the list, either on their own threads or
+	// on the executor (see setExecutorEnabled()).
+	// It returns true if all the cameras have been started.
+	auto start()
+	{
+		auto b = true;
+		for (auto& cam : m_list)
+		{
+			if (cam->getCamThread())
+				cam->getCamThread()->setGrabGroup(m_group.get());
+
+			if (m_executor && !m_group)
+				b = cam->start(*m_executor) && b;
+			else
+				b = cam->start() && b;
+		}
+		return b;
+	}
+	// Description:
+	// Function that stops all the cameras of the list and releases all the camera devices.
+	// It returns true if all the cameras have been disconnected.
+	auto disconnect()
+	{
+		auto b = true;
+		for (auto& cam : m_list)
+			b = cam->disconnect() && b;
+		return b;
+	}
+
+	// Description:
+	// Function that returns true if the camera or the processing thread of a camera of the list is running.
+	auto isRunning() const
+	{
+		for (const auto& cam : m_list)
+		{
+			if ((cam->getCamThread() && cam->getCamThread()->isRunning()) ||
+				(cam->getProcThread() && cam->getProcThread()->isRunning()))
+				return true;
+		}
+		return false;
+	}
+
 	// Description:
 	// Function to get the total number of cameras in the list.
 	auto getSize() const { return m_list.size(); }
@@ -211,6 +327,8 @@ public:
 
 private:
 	std::vector<CAMERA*> m_list;
+	std::unique_ptr<fvkExecutor> m_executor;	// shared by all the cameras in the executor mode.
+	std::unique_ptr<fvkGrabGroup> m_group;		// cameras that grab at the same instant.
 };
 
 }
@@ -26,11 +26,31 @@ extended in order to make any camera device compatible to this library.
 
 #include "fvkCameraThreadAbstract.h"
 #include "fvkSemaphoreBuffer.h"
+#include "fvkBroadcastBuffer.h"
+#include "fvkFrame.h"
+#include "fvkFramePool.h"
+#include "fvkGrabGroup.h"
 #include "fvkThread.h"
 
 namespace R3D
 {
 
+// Description:
+// What the camera thread does when the consumer of the semaphore buffer (the processing
+// thread) takes the frames slower than they are grabbed.
+// None keeps grabbing at the frame rate, the frames that do not fit are dropped by the buffer policy.
+// Throttle lowers the grab rate to the rate at which the consumer takes the frames out of the
+// buffer, and raises it again up to the frame rate when the consumer catches up.
+// Skip keeps grabbing at the frame rate, but a frame that the buffer would drop (full buffer
+// with fvkBufferPolicy::DropNewest) is only grabbed from the device, it is not retrieved
+// (decoded) nor copied, unless a subscriber or the video output needs it.
+enum class fvkBackpressure
+{
+	None,
+	Throttle,
+	Skip
+};
+
 class FVK_CAMERA_EXPORT fvkCameraThread : public fvkThread, public fvkCameraThreadAbstract
 {
 public:
@@ -42,13 +62,16 @@ public:
 	// _frame_size is the desired width and height of camera frame.
 	// Specifying Size(-1, -1) will do the auto-selection for the captured frame size,
 	// normally it enables the 640x480 resolution on most of web cams.
-	fvkCameraThread(const int device_index, const cv::Size& frame_size, fvkSemaphoreBuffer<cv::Mat>* buffer = nullptr);
+	fvkCameraThread(const int device_index, const cv::Size& frame_size, fvkSemaphoreBuffer<fvkFrame>* buffer = nullptr);
 	// Description:
 	// Default destructor that expected to be overridden.
 	virtual ~fvkCameraThread() = default;
 
 	// Description:
-	// Function to get the current grabbed frame.
+	// Function to get the current grabbed frame (its region-of-interest).
+	// It waits for the next frame, and it does not take frames away from the processing thread
+	// or from the other subscribers. The frame is a private copy, so the caller can modify it
+	// and keep it without holding a pooled frame of the camera.
 	auto getFrame() -> cv::Mat override;
 
 	// Description:
@@ -56,20 +79,42 @@ public:
 	// The display function should be capable of handling multi-threading updating.
 	// The second argument which is fvkThreadStats will give you statistics of the thread,
 	// such as Average frames per second (FPS) and number of processed frames.
+	// The frame comes with its capture time, sequence number and camera index (see fvkFrame).
+	void setVideoOutput(const std::function<void(fvkFrame&, const fvkThreadStats&)> f);
+	// Description:
+	// Set a GUI function to display the grabbed frame, it only gets the image of the frame.
 	void setVideoOutput(const std::function<void(cv::Mat&, const fvkThreadStats&)> f);
 
 	// Description:
 	// Function to set a pointer to semaphore buffer which does synchronization between capturing and processing threads.
-	void setSemaphoreBuffer(fvkSemaphoreBuffer<cv::Mat>* p) { p_buffer = p; }
+	void setSemaphoreBuffer(fvkSemaphoreBuffer<fvkFrame>* p) { p_buffer = p; }
 	// Description:
 	// Function to get a pointer to semaphore buffer which does synchronization between capturing and processing threads.
 	auto getSemaphoreBuffer() const { return p_buffer; }
 
+	// Description:
+	// Function to get a reference to the fan-out buffer of the additional frame consumers
+	// (recorder, display, analytics, ...). Every subscriber receives the grabbed frames
+	// according to its own lag policy, independently of the processing thread.
+	// All the subscribers share the same frame data, no copy is made per subscriber.
+	auto& subscribers() { return m_subscribers; }
+
+	// Description:
+	// Function to get a reference to the pool of the frame buffers that are handed to the processing thread,
+	// the devices that convert or generate their frames (V4L2, synthetic) take them from this pool as well.
+	// The pool size should be at least the buffer capacity plus the frames that are being processed or displayed,
+	// when all the pooled frames are in use, a new grabbed frame is dropped without being copied (with
+	// fvkBufferPolicy::DropOldest, the oldest buffered frame is dropped instead to free its pooled frame).
+	// getFrame() and setGrabGroup() add the frame that they hold to the pool.
+	auto& framePool() { return m_pool; }
+
 	// Description:
 	// Function to reset the region-of-interest as same as the grabbed frame size.
 	void resetRoi();
 	// Description:
 	// Function to set the region-of-interest of the grabbed frame.
+	// The grabbed frames are not handed out while it is out of the frame (or smaller than 2x2),
+	// its bounds are only checked when it or the frame size changes.
 	void setRoi(const cv::Rect& roi);
 	// Description:
 	// Function to get the region-of-interest of the grabbed frame.
@@ -85,6 +130,49 @@ public:
 	// Function that returns true if the buffer synchronization is enabled.
 	auto isSyncEnabled() const -> bool;
 
+	// Description:
+	// Function to set what this thread does when the consumer of the buffer is slower than
+	// the capturing, see fvkBackpressure. Default is fvkBackpressure::None.
+	void setBackpressure(const fvkBackpressure policy);
+	// Description:
+	// Function to get what this thread does when the consumer of the buffer is slower than the capturing.
+	auto getBackpressure() const -> fvkBackpressure;
+	// Description:
+	// Function that returns the grab rate (frames per second) that fvkBackpressure::Throttle
+	// has converged to, it is the frame rate when the capturing is not throttled.
+	auto getThrottledFrameRate() const -> double;
+	// Description:
+	// Function that returns the number of frames that were grabbed without being retrieved
+	// by fvkBackpressure::Skip since the start of this thread.
+	auto getSkippedFrames() const -> unsigned long long;
+
+	// Description:
+	// Function to set the group of the cameras that grab their frames at the same instant
+	// (see fvkGrabGroup), nullptr to grab independently. In a group, this thread latches the
+	// frame together with the others and retrieves it afterwards, and it does not skip frames
+	// for fvkBackpressure::Skip. The OpenCV, V4L2 and synthetic threads latch without decoding,
+	// a derived thread that only overrides grab() decodes inside the barrier (see latch()). The thread joins the group when it starts and leaves it when
+	// it stops, so the group is only changed while this thread is not running, otherwise the
+	// call is refused and returns false. The group must outlive the runs of this thread.
+	auto setGrabGroup(fvkGrabGroup* group) -> bool;
+	// Description:
+	// Function to get the group of the cameras that grab their frames at the same instant.
+	auto getGrabGroup() const { return p_group; }
+
+	// Description:
+	// Function to request that the device is closed and opened again, for example by a watchdog
+	// when this thread has stalled (see fvkWatchdog). It is done by this thread at its next
+	// iteration, so a grab() that hangs is not interrupted: the device is reopened as soon as it
+	// returns (a backend timeout), and a grab() that never returns is not recovered.
+	// If the device can not be opened, it is tried again every second.
+	// The other cameras are not touched.
+	void requestReopen();
+
+	// Description:
+	// Overridden function that returns false while a blocking buffer (fvkBufferPolicy::Block
+	// or synchronization) is full, so an executor does not block its thread in put().
+	auto ready() -> bool override;
+
 protected:	
 	// Description:
 	// Overridden function to grab and process the camera frame.
@@ -93,16 +181,76 @@ protected:
 	// Description:
 	// Pure virtual function to be overridden to grab/capture the frame. 
 	auto grab(cv::Mat& frame) -> bool override = 0;
+	// Description:
+	// Virtual function to grab the next frame of the device without retrieving it, it is used
+	// by fvkBackpressure::Skip. It can be overridden by the devices that can grab without decoding,
+	// by default the frame is grabbed and discarded.
+	virtual auto skip() -> bool;
+	// Description:
+	// Virtual function that returns the timestamp (in milliseconds, on the clock of the device) of the
+	// frame that grab() has returned last, it is the device time of the fvkFrame. It can be overridden
+	// by the devices that have a timestamp, by default it returns -1 (unknown).
+	virtual auto timestamp() -> double;
+	// Description:
+	// Virtual function that returns true if the frame that grab() has returned last belongs to the
+	// caller: the device does not write into it anymore and nobody else modifies it, so its
+	// region-of-interest is handed out as a view without a copy. By default it returns false, and
+	// the region-of-interest is copied into a pooled frame (see framePool()).
+	virtual auto isFrameOwned() const -> bool;
+	// Description:
+	// Virtual functions that split grab() for a grab group (see setGrabGroup()): latch() takes the next
+	// frame of the device as quickly as possible, and retrieve() decodes the latched frame afterwards.
+	// They can be overridden by the devices that grab and decode in two steps, by default latch()
+	// calls grab() and retrieve() hands out its frame.
+	virtual auto latch() -> bool;
+	virtual auto retrieve(cv::Mat& frame) -> bool;
+
+	// Description:
+	// Overridden functions that reset the backpressure of a new run, and that lower the
+	// grab rate while it is throttled.
+	void onStart() override;
+	void onStop() override;
+	auto getIterationDelay() -> long long override;
+
+	// Description:
+	// Function that adapts the grab rate to the rate of the consumer (fvkBackpressure::Throttle).
+	void throttle();
+	// Description:
+	// Function that closes and opens the device again (see requestReopen()).
+	void reopen();
+	// Description:
+	// Function that takes the current region-of-interest and checks it against the given frame size.
+	void updateRoi(const cv::Size& frame_size);
 
 	// Description:
 	// protected member variables.
-	fvkSemaphoreBuffer<cv::Mat> *p_buffer;
-	std::function<void(cv::Mat&, const fvkThreadStats&)> m_video_output_func;
+	fvkSemaphoreBuffer<fvkFrame> *p_buffer;
+	std::function<void(fvkFrame&, const fvkThreadStats&)> m_video_output_func;
 	std::mutex m_syncmutex;
 	std::mutex m_repeatmutex;
 	std::atomic<bool> m_sync_proc_thread;
 	std::mutex m_rectmutex;
 	cv::Rect m_rect;
+	std::atomic<bool> m_roi_changed;		// the region-of-interest has been set since it was last checked.
+	cv::Rect m_roi;							// checked region-of-interest, only used by this thread.
+	cv::Size m_roi_frame;					// frame size that m_roi has been checked against.
+	bool m_roi_valid;						// m_roi is inside the frame.
+	bool m_roi_full;						// m_roi is the whole frame.
+	fvkFramePool m_pool;
+	fvkBroadcastBuffer<fvkFrame> m_subscribers;
+	std::mutex m_latestmutex;
+	fvkBroadcastBuffer<fvkFrame>::Subscriber m_latest;	// subscriber used by getFrame().
+	std::atomic<fvkBackpressure> m_backpressure;
+	std::atomic<long long> m_throttle;		// throttled delay between the frames in nanoseconds, 0 if not throttled.
+	std::atomic<unsigned long long> m_nskipped;
+	std::chrono::steady_clock::time_point m_bp_time;	// start of the current throughput measurement.
+	std::uint64_t m_bp_gets;				// frames taken by the consumer before the measurement.
+	std::uint64_t m_bp_dropped;				// frames dropped by the buffer before the measurement.
+	std::atomic<bool> m_reopen;				// the device has to be reopened.
+	std::chrono::steady_clock::time_point m_reopen_time;	// earliest time of the next reopen attempt.
+	std::uint64_t m_sequence;				// sequence number of the next grabbed frame.
+	fvkGrabGroup* p_group;					// cameras that grab at the same instant, nullptr if none.
+	cv::Mat m_latched;						// frame of the default latch() until retrieve().
 };
 
 }
@@ -43,7 +43,7 @@ public:
 	// Specifying Size(-1, -1) will do the auto-selection for the captured frame size,
 	// normally it enables the 640x480 resolution on most of web cams.
 	// buffer is the semaphore buffer to synchronizer the processing thread with this camera thread.
-	fvkCameraThreadOpenCV(const int device_index, const cv::Size& frame_size, const int api = static_cast<int>(cv::VideoCaptureAPIs::CAP_ANY), fvkSemaphoreBuffer<cv::Mat>* buffer = nullptr);
+	fvkCameraThreadOpenCV(const int device_index, const cv::Size& frame_size, const int api = static_cast<int>(cv::VideoCaptureAPIs::CAP_ANY), fvkSemaphoreBuffer<fvkFrame>* buffer = nullptr);
 	// Description:
 	// Default constructor to start the given video file.
 	// buffer is the semaphore to synchronizer the processing thread with this thread.
@@ -51,7 +51,7 @@ public:
 	// If width and height is specified, then this will become the video frame resolution.
 	// cv::Size(-1, -1) will do the auto-selection of the resolution, normally it enable the 640x480 resolution.
 	// api = cv::VideoCaptureAPIs::CAP_ANY is the preferred API for a capture object. for more info see (cv::VideoCaptureAPIs).
-	fvkCameraThreadOpenCV(const std::string& video_file, const cv::Size& frame_size, const int api = static_cast<int>(cv::VideoCaptureAPIs::CAP_ANY), fvkSemaphoreBuffer<cv::Mat>* buffer = nullptr);
+	fvkCameraThreadOpenCV(const std::string& video_file, const cv::Size& frame_size, const int api = static_cast<int>(cv::VideoCaptureAPIs::CAP_ANY), fvkSemaphoreBuffer<fvkFrame>* buffer = nullptr);
 	// Description:
 	// Default destructor that stops the threads and closes the camera device.
 	virtual ~fvkCameraThreadOpenCV();
@@ -266,6 +266,18 @@ protected:
 	// In order to grab from the camera device, the video file path
 	// should be empty, like setVideoFile("");
 	auto grab(cv::Mat& m_frame) -> bool override;
+	// Description:
+	// Overridden function to grab the next frame without retrieving (decoding) it.
+	auto skip() -> bool override;
+	// Description:
+	// Overridden function that returns the position of the video file, or the timestamp of the
+	// frame if the capture backend has one (CAP_PROP_POS_MSEC), in milliseconds.
+	auto timestamp() -> double override;
+	// Description:
+	// Overridden functions that grab the next frame of a grab group (cv::VideoCapture::grab()),
+	// and decode it afterwards (cv::VideoCapture::retrieve()).
+	auto latch() -> bool override;
+	auto retrieve(cv::Mat& frame) -> bool override;
 
 	cv::VideoCapture m_cam;
 	int m_videocapture_api;
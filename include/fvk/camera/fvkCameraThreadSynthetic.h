@@ -0,0 +1,174 @@
+#pragma once
+#ifndef fvkCameraThreadSynthetic_h__
+#define fvkCameraThreadSynthetic_h__
+
+/*********************************************************************************
+created:	2026/10/18   08:30PM
+filename: 	fvkCameraThreadSynthetic.h
+file base:	fvkCameraThreadSynthetic
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	camera thread that generates deterministic test patterns instead of
+grabbing from a device, so the whole pipeline (capturing, buffer, processing,
+recording) can be tested and benchmarked reproducibly without a camera.
+The frame n of a pattern only depends on n and on the seed, and the simulated grab
+latency and jitter come from a random generator with the same seed, so two runs with
+the same settings produce the same frames and the same delays.
+
+usage example:
+--------------
+
+auto ct = new fvkCameraThreadSynthetic(0, cv::Size(1280, 720), CV_8UC3, fvkSyntheticPattern::Face);
+ct->setFrameRate(60);
+ct->setLatency(5.0, 1.0);		// 5 +/- 1 milliseconds per grab.
+fvkCamera cam(ct);
+cam.connect();
+cam.start();
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include "fvkCameraThread.h"
+
+#include <atomic>
+#include <chrono>
+#include <random>
+
+namespace R3D
+{
+
+// Description:
+// Test patterns of fvkCameraThreadSynthetic.
+// Gradient is a colour gradient that moves by a few pixels every frame.
+// Noise is uniform random noise, a new image every frame (the worst case for compression and denoising).
+// Face is a face image that moves on top of the moving gradient (for the face detection and tracking).
+enum class fvkSyntheticPattern
+{
+	Gradient,
+	Noise,
+	Face
+};
+
+class FVK_CAMERA_EXPORT fvkCameraThreadSynthetic : public fvkCameraThread
+{
+public:
+	// Description:
+	// Constructor that creates a synthetic camera with the given frame size and type
+	// (CV_8UC1, CV_8UC3, CV_8UC4, CV_16UC1, ...). Size(-1, -1) gives 640x480.
+	fvkCameraThreadSynthetic(const int device_index, const cv::Size& frame_size, const int type = CV_8UC3, const fvkSyntheticPattern pattern = fvkSyntheticPattern::Gradient, fvkSemaphoreBuffer<fvkFrame>* buffer = nullptr);
+	// Description:
+	// Default destructor that stops the thread.
+	virtual ~fvkCameraThreadSynthetic();
+
+	// Description:
+	// Function that prepares the pattern, it always succeeds.
+	auto open() -> bool override;
+	// Description:
+	// Function that returns true if the pattern is prepared.
+	auto isOpened() const -> bool override;
+	// Description:
+	// Function that releases the pattern.
+	auto close() -> bool override;
+
+	// Description:
+	// Function to set the pattern. This should be called before calling the open() function.
+	void setPattern(const fvkSyntheticPattern pattern) { m_pattern = pattern; }
+	// Description:
+	// Function to get the pattern.
+	auto getPattern() const { return m_pattern; }
+	// Description:
+	// Function to set the type of the frames (CV_8UC3, ...). This should be called before calling the open() function.
+	void setFrameType(const int type) { m_type = type; }
+	// Description:
+	// Function to get the type of the frames.
+	auto getFrameType() const { return m_type; }
+	// Description:
+	// Function to set the face image of fvkSyntheticPattern::Face, for example a photo for the face detection.
+	// By default, a simple drawn face is used. This should be called before calling the open() function.
+	void setFaceImage(const cv::Mat& face) { m_face_image = face.clone(); }
+	// Description:
+	// Function to set the seed of the noise and of the simulated latency, the same seed gives the same run.
+	// This should be called before calling the open() function.
+	void setSeed(const unsigned seed) { m_seed = seed; }
+	// Description:
+	// Function to get the seed of the noise and of the simulated latency.
+	auto getSeed() const { return m_seed; }
+
+	// Description:
+	// Function to simulate the time that a device takes to deliver a frame, every grab takes
+	// latency milliseconds plus a uniform random jitter in [-jitter, +jitter] milliseconds.
+	// Default is 0 (no latency). It can be changed while the thread is running.
+	void setLatency(const double latency, const double jitter = 0.0);
+	// Description:
+	// Function to get the simulated grab latency in milliseconds.
+	auto getLatency() const -> double { return m_latency; }
+	// Description:
+	// Function to get the simulated grab jitter in milliseconds.
+	auto getJitter() const -> double { return m_jitter; }
+
+	// Description:
+	// Function that returns the number of frames that have been generated since open().
+	auto getGeneratedFrames() const -> unsigned long long { return m_index; }
+
+protected:
+	// Description:
+	// Function that prepares the pattern, device_index is only used as the camera index.
+	auto open(const int device_index) -> bool override;
+	// Description:
+	// Overridden function that generates the next frame of the pattern.
+	auto grab(cv::Mat& frame) -> bool override;
+	// Description:
+	// Overridden functions that split grab() for a grab group: latch() waits for the simulated
+	// latency and takes the timestamp, retrieve() generates the latched frame afterwards.
+	auto latch() -> bool override;
+	auto retrieve(cv::Mat& frame) -> bool override;
+	// Description:
+	// Overridden function that skips the next frame of the pattern without generating it.
+	auto skip() -> bool override;
+	// Description:
+	// Overridden function that returns the time of the last generated frame in milliseconds since open().
+	auto timestamp() -> double override;
+	// Description:
+	// Overridden function that returns true if the last frame has been generated into a pooled frame
+	// (the gradient frames are views of the shared background, so they are not).
+	auto isFrameOwned() const -> bool override;
+
+	// Description:
+	// Function that waits for the simulated grab latency.
+	void wait();
+	// Description:
+	// Functions that prepare the moving background and the face image.
+	void createBackground();
+	void createFace();
+
+	std::atomic<bool> m_isopen;
+	int m_type;
+	fvkSyntheticPattern m_pattern;
+	unsigned m_seed;
+	std::atomic<double> m_latency;
+	std::atomic<double> m_jitter;
+	std::mt19937 m_rng;						// generator of the jitter.
+	std::atomic<unsigned long long> m_index;	// index of the next frame.
+	std::chrono::steady_clock::time_point m_open_time;
+	double m_timestamp;						// time of the last generated frame since open().
+	long long m_latched_index;				// index of the frame latched by latch(), -1 if none.
+	bool m_owned;							// the last frame has been generated into a pooled frame.
+	cv::Mat m_background;					// periodic gradient, twice as wide as a frame.
+	cv::Mat m_face_image;					// face image given by the user.
+	cv::Mat m_face;							// face image of the frame type.
+};
+
+}
+
+#endif // fvkCameraThreadSynthetic_h__
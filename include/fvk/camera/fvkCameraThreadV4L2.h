@@ -0,0 +1,228 @@
+#pragma once
+#ifndef fvkCameraThreadV4L2_h__
+#define fvkCameraThreadV4L2_h__
+
+/*********************************************************************************
+created:	2026/10/18   09:15PM
+filename: 	fvkCameraThreadV4L2.h
+file base:	fvkCameraThreadV4L2
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	camera thread that streams directly from a Video4Linux2 device (Linux only)
+through memory-mapped driver buffers, instead of going through cv::VideoCapture.
+The driver fills a configurable number of buffers (the queue depth), a dequeued buffer
+is handed out as a cv::Mat that points into the mapped memory (no copy), and it is
+given back to the driver as soon as nobody refers to that cv::Mat anymore.
+Frames in a packed format that is not BGR (YUYV, UYVY, MJPEG) are converted into a BGR
+frame of the frame pool (see framePool()), unless the raw frames are requested (setConvertToBGR(false)).
+All the calls to the device go through a few virtual functions (deviceOpen(), deviceIoctl(),
+deviceMap(), ...), so the thread can be tested against a mocked driver as well as against
+the virtual devices (vivid, v4l2loopback).
+
+usage example:
+--------------
+
+auto ct = new fvkCameraThreadV4L2(0, cv::Size(1280, 720));
+ct->setBufferCount(4);
+ct->setPixelFormat(fvkCameraThreadV4L2::fourcc('Y', 'U', 'Y', 'V'));
+fvkCamera cam(ct);
+cam.connect();
+cam.start();
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include "fvkCameraThread.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkCameraThreadV4L2 : public fvkCameraThread
+{
+public:
+	// Description:
+	// Constructor that creates a camera thread for the device /dev/video<device_index>.
+	// Specifying Size(-1, -1) keeps the current resolution of the device.
+	fvkCameraThreadV4L2(const int device_index, const cv::Size& frame_size, fvkSemaphoreBuffer<fvkFrame>* buffer = nullptr);
+	// Description:
+	// Constructor that creates a camera thread for the given device path, like "/dev/video2".
+	fvkCameraThreadV4L2(const std::string& device_path, const cv::Size& frame_size, fvkSemaphoreBuffer<fvkFrame>* buffer = nullptr);
+	// Description:
+	// Default destructor that stops the thread and closes the device.
+	virtual ~fvkCameraThreadV4L2();
+
+	// Description:
+	// Function that opens the device, sets the format, maps the buffers and starts the streaming.
+	// It returns true on success.
+	auto open() -> bool override;
+	// Description:
+	// Function that returns true if the device is streaming.
+	auto isOpened() const -> bool override;
+	// Description:
+	// Function that stops the streaming, unmaps the buffers and closes the device.
+	// A frame that is still referred to by a consumer stays valid, its buffer is left mapped
+	// until the last reference is gone, then it is unmapped by the next grab or open().
+	// The driver only releases the buffers once all of them are unmapped.
+	auto close() -> bool override;
+
+	// Description:
+	// Function to make a V4L2 four-character code, like fourcc('Y', 'U', 'Y', 'V').
+	static constexpr auto fourcc(const char a, const char b, const char c, const char d) -> std::uint32_t
+	{
+		return static_cast<std::uint32_t>(a) | (static_cast<std::uint32_t>(b) << 8) | (static_cast<std::uint32_t>(c) << 16) | (static_cast<std::uint32_t>(d) << 24);
+	}
+
+	// Description:
+	// Function to set the device path, like "/dev/video0". This should be called before calling the open() function.
+	void setDevicePath(const std::string& path) { m_path = path; }
+	// Description:
+	// Function to get the device path.
+	auto getDevicePath() const { return m_path; }
+	// Description:
+	// Function to set the number of the driver buffers. More buffers let the driver keep capturing
+	// while the consumers hold frames, fewer buffers give a lower latency. Default is 4.
+	// The driver may give a different number, see getBufferCount(). This should be called before calling the open() function.
+	void setBufferCount(const std::size_t n) { m_nbuffers = n; }
+	// Description:
+	// Function to get the number of the driver buffers (the number that the driver has given once opened).
+	auto getBufferCount() const { return m_nbuffers; }
+	// Description:
+	// Function to set the pixel format that is requested from the device (see fourcc()).
+	// YUYV, UYVY, GREY, BGR3 (BGR24) and MJPG are supported. Default is YUYV.
+	// The driver may give a different format, see getPixelFormat(). This should be called before calling the open() function.
+	void setPixelFormat(const std::uint32_t fourcc) { m_pixelformat = fourcc; }
+	// Description:
+	// Function to get the pixel format of the device.
+	auto getPixelFormat() const { return m_pixelformat; }
+	// Description:
+	// Function to set whether the frames are converted to BGR (true, default) or handed out
+	// as they are delivered by the driver (CV_8UC2 for YUYV and UYVY, a 1xN CV_8UC1 row for MJPG).
+	// GREY and BGR24 frames are never converted, so they are always handed out without a copy.
+	void setConvertToBGR(const bool b) { m_convert = b; }
+	// Description:
+	// Function that returns true if the frames are converted to BGR.
+	auto isConvertToBGR() const { return m_convert; }
+	// Description:
+	// Function to set the time in milliseconds that grab() waits for a frame before it fails. Default is 1000.
+	void setTimeout(const int ms) { m_timeout = ms; }
+	// Description:
+	// Function to get the time in milliseconds that grab() waits for a frame.
+	auto getTimeout() const { return m_timeout; }
+
+	// Description:
+	// Function to set the frame rate of the device (VIDIOC_S_PARM), it returns false if the driver does not support it.
+	auto setFps(const double fps) -> bool;
+	// Description:
+	// Function to get the frame rate of the device, 0 if it is unknown.
+	auto getFps() const -> double;
+
+	// Description:
+	// Function that returns the number of buffers that are queued in the driver right now.
+	auto getQueuedBuffers() const -> std::size_t { return m_nqueued; }
+	// Description:
+	// Function that returns the number of frames that the driver has lost since open() (gaps in
+	// its sequence numbers), mostly because it had no queued buffer (all of them were held).
+	auto getLostFrames() const -> unsigned long long { return m_nlost; }
+
+protected:
+	// Description:
+	// Function that opens the device, device_index is used if no device path is set.
+	auto open(const int device_index) -> bool override;
+	// Description:
+	// Overridden function that dequeues the next filled buffer and hands it out without a copy
+	// (or converted to BGR, see setConvertToBGR()).
+	auto grab(cv::Mat& frame) -> bool override;
+	// Description:
+	// Overridden functions that split grab() for a grab group: latch() only dequeues the next filled
+	// buffer (and takes its timestamp), retrieve() converts it afterwards (see setConvertToBGR()).
+	auto latch() -> bool override;
+	auto retrieve(cv::Mat& frame) -> bool override;
+	// Description:
+	// Overridden function that dequeues the next filled buffer and gives it back to the driver at once.
+	auto skip() -> bool override;
+	// Description:
+	// Overridden function that returns the driver timestamp of the last dequeued frame in milliseconds
+	// (on the monotonic clock of the kernel for most drivers).
+	auto timestamp() -> double override;
+	// Description:
+	// Overridden function that returns true if the last frame has been converted into a pooled BGR frame,
+	// the raw frames are copied by the camera thread, so their buffers go back to the driver at once.
+	auto isFrameOwned() const -> bool override;
+
+	// Description:
+	// Functions that access the device, they can be overridden to mock the driver.
+	// They work like open(2), close(2), ioctl(2) (restarted on EINTR), mmap(2) (nullptr on failure),
+	// munmap(2) and poll(2) (1 when a frame can be dequeued, 0 on timeout, -1 on error), errno is set on failure.
+	// A derived class that overrides them must call close() in its own destructor.
+	virtual auto deviceOpen(const std::string& path) -> int;
+	virtual void deviceClose(const int fd);
+	virtual auto deviceIoctl(const int fd, const unsigned long request, void* arg) -> int;
+	virtual auto deviceMap(const int fd, const std::size_t length, const long long offset) -> void*;
+	virtual void deviceUnmap(void* start, const std::size_t length);
+	virtual auto deviceWait(const int fd, const int timeout) -> int;
+
+private:
+	struct Buffer
+	{
+		void* start;
+		std::size_t length;
+		cv::Mat mat;		// header of the whole buffer, it owns one reference of the buffer data.
+		bool queued;		// true while the driver owns the buffer.
+	};
+
+	// dequeue the next filled buffer, it returns its index or -1.
+	auto dequeue(std::uint32_t& bytesused) -> int;
+	// give the buffers that nobody refers to anymore back to the driver.
+	void requeue();
+	auto queue(const std::size_t index) -> bool;
+	// wrap a mapped buffer into a cv::Mat that counts its references.
+	auto wrap(Buffer& b) const -> cv::Mat;
+	// the raw frame of a filled buffer.
+	auto view(const Buffer& b, const std::uint32_t bytesused) const -> cv::Mat;
+	void release();
+	// unmap the buffers of a previous run that nobody refers to anymore.
+	void reap();
+
+	std::string m_path;
+	std::uint32_t m_pixelformat;
+	std::size_t m_nbuffers;
+	bool m_convert;
+	int m_timeout;
+	int m_fd;
+	std::atomic<bool> m_streaming;
+	std::size_t m_bytesperline;
+	std::vector<Buffer> m_buffers;
+	std::vector<Buffer> m_orphans;		// buffers of a previous run that are still referred to by consumers.
+	long long m_driver_sequence;		// sequence number of the last dequeued frame, -1 before the first one.
+	double m_timestamp;					// timestamp of the last dequeued frame in milliseconds.
+	bool m_converted;					// the last frame has been converted into a pooled BGR frame.
+	int m_latched_index;				// index of the buffer dequeued by latch(), -1 if none.
+	std::uint32_t m_latched_bytes;		// bytes used in the latched buffer.
+	std::atomic<std::size_t> m_nqueued;
+	std::atomic<unsigned long long> m_nlost;
+};
+
+}
+
+#endif // __linux__
+
+#endif // fvkCameraThreadV4L2_h__
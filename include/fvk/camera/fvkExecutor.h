@@ -0,0 +1,188 @@
+#pragma once
+#ifndef fvkExecutor_h__
+#define fvkExecutor_h__
+
+/*********************************************************************************
+created:	2026/10/18   04:10PM
+filename: 	fvkExecutor.h
+file base:	fvkExecutor
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	fixed-size work-stealing thread pool, and a task that runs a fvkThread
+on it one iteration at a time.
+Every worker has its own queue of tasks, a task posted by a worker goes to its own
+queue, a task posted by any other thread is spread over the queues. A worker takes
+the tasks of its own queue in order, and an idle worker steals the oldest task of
+another queue, so no worker is idle while there are tasks waiting. Delayed tasks are
+kept in one timer queue and moved to a worker queue when they are due.
+
+With fvkThreadTask, many cameras share a few OS threads instead of two dedicated
+threads per camera: each iteration of a camera or processing thread is a separate
+task that posts the next iteration when it is due, so a camera never occupies a
+worker for longer than one iteration, and the cameras take turns fairly.
+
+usage example:
+--------------
+
+fvkExecutor executor;			// one worker per core.
+executor.post([]() { ... });
+executor.postAt(std::chrono::steady_clock::now() + std::chrono::milliseconds(10), []() { ... });
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+#include "fvkStopToken.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace R3D
+{
+
+class fvkThread;
+
+class FVK_CAMERA_EXPORT fvkExecutor
+{
+public:
+	using Task = std::function<void()>;
+	using TimePoint = std::chrono::steady_clock::time_point;
+
+	// Description:
+	// Constructor that starts the given number of worker threads,
+	// 0 starts one worker per core.
+	explicit fvkExecutor(std::size_t nthreads = 0);
+	// Description:
+	// Destructor that stops and joins all the workers, the tasks that are
+	// still queued are discarded.
+	~fvkExecutor();
+
+	// Description:
+	// Non-implemented.
+	fvkExecutor(const fvkExecutor&) = delete;
+	fvkExecutor& operator=(const fvkExecutor&) = delete;
+
+	// Description:
+	// Function to queue a task that is executed as soon as a worker is free.
+	void post(Task task);
+	// Description:
+	// Function to queue a task that is executed when the given time point is reached.
+	void postAt(const TimePoint& time, Task task);
+
+	// Description:
+	// Function that returns the number of worker threads.
+	auto size() const -> std::size_t { return m_workers.size(); }
+
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+		std::thread thread;
+	};
+	struct Timer
+	{
+		TimePoint time;
+		Task task;
+		auto operator<(const Timer& other) const -> bool { return time > other.time; }	// earliest first.
+	};
+
+	void work(std::size_t index);
+	void push(std::size_t index, Task task);
+	auto pop(std::size_t index, Task& task) -> bool;
+	auto steal(std::size_t index, Task& task) -> bool;
+	// move the due timers to the queue of the given worker, it returns true if there was any.
+	auto dueTimers(std::size_t index) -> bool;
+	void wakeOne();
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::atomic<std::size_t> m_next;		// queue of the next task that is posted by another thread.
+	std::atomic<long long> m_pending;		// number of queued tasks.
+	std::atomic<int> m_idle;				// number of workers that sleep.
+	std::atomic<long long> m_next_timer;	// time of the earliest timer in nanoseconds, LLONG_MAX if none.
+	std::atomic<bool> m_stop;
+	std::mutex m_mutex;						// protects the timers and the sleep of the workers.
+	std::condition_variable m_cond;
+	std::priority_queue<Timer> m_timers;
+};
+
+// Description:
+// Task that runs a fvkThread on an executor one iteration at a time (see fvkThread::step()).
+// An iteration is posted when it is due, when the thread is not ready() the task waits until
+// it is woken up by wake() (the peer task wakes it after each of its iterations) or by the
+// stop request of the token. The executor must outlive the task.
+class FVK_CAMERA_EXPORT fvkThreadTask : public std::enable_shared_from_this<fvkThreadTask>
+{
+public:
+	// Description:
+	// Function that begins a new run of the given thread (fvkThread::begin()) and posts
+	// its first iteration. The run ends when the stop of token is requested or stop() is
+	// called on the thread.
+	static auto start(fvkExecutor& executor, fvkThread* thread, const fvkStopToken& token, std::function<void()> func = nullptr) -> std::shared_ptr<fvkThreadTask>;
+
+	// Description:
+	// Function to set the task that is woken up after every iteration of this task, for
+	// example the processing task of a camera task that has just put a frame, and vice versa.
+	void setPeer(const std::shared_ptr<fvkThreadTask>& peer);
+	// Description:
+	// Function that makes the task look at its thread again right away.
+	void wake();
+	// Description:
+	// Function that blocks until the run of the thread is over.
+	void wait();
+	// Description:
+	// Function that returns true if the run of the thread is over.
+	auto isFinished() const -> bool { return m_state.load() == Finished; }
+
+	// Description:
+	// Non-implemented.
+	fvkThreadTask(const fvkThreadTask&) = delete;
+	fvkThreadTask& operator=(const fvkThreadTask&) = delete;
+
+	// use start().
+	fvkThreadTask(fvkExecutor& executor, fvkThread* thread, std::function<void()> func);
+
+private:
+	enum State : int
+	{
+		Waiting,	// waiting for its deadline or for wake().
+		Queued,		// posted or executing an iteration.
+		Finished
+	};
+
+	void iterate();
+	// wait for wake() until the given deadline.
+	void schedule(const std::chrono::steady_clock::time_point& deadline);
+
+	fvkExecutor& m_executor;
+	fvkThread* p_thread;
+	std::function<void()> m_func;
+	std::atomic<int> m_state;
+	std::atomic<bool> m_kick;			// woken up while an iteration was queued.
+	std::atomic<unsigned> m_generation;	// a timer of an older generation is ignored.
+	std::weak_ptr<fvkThreadTask> m_peer;
+	std::unique_ptr<fvkStopCallback> m_stopcb;
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+};
+
+}
+
+#endif // fvkExecutor_h__
@@ -0,0 +1,88 @@
+#pragma once
+#ifndef fvkFrame_h__
+#define fvkFrame_h__
+
+/*********************************************************************************
+created:	2026/10/18   09:50PM
+filename: 	fvkFrame.h
+file base:	fvkFrame
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	envelope of a grabbed frame that travels through the pipeline (semaphore
+buffer, subscribers, present() and the video output) together with the image:
+when it was captured (steady clock and device clock), its sequence number and the
+index of its camera. So a consumer can measure the latency from the capture
+(frame.age()) and find the frames that were lost on the way (gaps in the sequence).
+
+usage example:
+--------------
+
+cam.setVideoOutput([](fvkFrame& f, const fvkThreadStats& s)
+{
+	static std::uint64_t last = 0;
+	if (f.sequence > last + 1) std::cout << f.sequence - last - 1 << " frames lost\n";
+	last = f.sequence;
+	std::cout << std::chrono::duration<double, std::milli>(f.age()).count() << " ms since the capture\n";
+});
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkFrame
+{
+public:
+	// Description:
+	// Default constructor that creates an empty frame (end of a stream).
+	fvkFrame() :
+		device_time(-1),
+		sequence(0),
+		camera(-1)
+	{
+	}
+	// Description:
+	// Constructor that creates a frame of the given image without capture information.
+	explicit fvkFrame(cv::Mat _image) :
+		image(std::move(_image)),
+		device_time(-1),
+		sequence(0),
+		camera(-1)
+	{
+	}
+
+	// Description:
+	// Function that returns true if the frame has no image.
+	auto empty() const -> bool { return image.empty(); }
+	// Description:
+	// Function that returns the time since the frame was captured.
+	auto age() const -> std::chrono::steady_clock::duration { return std::chrono::steady_clock::now() - capture_time; }
+
+	cv::Mat image;
+	std::chrono::steady_clock::time_point capture_time;		// when the camera thread got the frame from the device, before decoding it.
+	double device_time;			// timestamp of the device in milliseconds (its own clock), -1 if unknown.
+	std::uint64_t sequence;		// number of the frame grabbed by the camera thread, the skipped and dropped frames are gaps.
+	int camera;					// index of the camera device, -1 if unknown.
+};
+
+}
+
+#endif // fvkFrame_h__
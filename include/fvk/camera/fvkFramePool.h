@@ -0,0 +1,89 @@
+#pragma once
+#ifndef fvkFramePool_h__
+#define fvkFramePool_h__
+
+/*********************************************************************************
+created:	2026/10/18   11:05AM
+filename: 	fvkFramePool.h
+file base:	fvkFramePool
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	thread-safe pool of pre-sized frame buffers that are recycled instead
+of being allocated for every frame. A frame handed out by acquire() shares its
+data with the pool, and it becomes available again as soon as the last consumer
+releases its cv::Mat (reference count goes back to the one owned by the pool).
+
+usage example:
+--------------
+
+fvkFramePool pool(4);
+cv::Mat frame;
+if (pool.acquire(cv::Size(640, 480), CV_8UC3, frame))
+	grabbed.copyTo(frame);	// no allocation, frame goes back to the pool when released.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkFramePool
+{
+public:
+	// Description:
+	// Default constructor that creates a pool of the given number of frames.
+	// Frame buffers are allocated on the first acquire() with the requested size and type.
+	explicit fvkFramePool(const std::size_t size = 4);
+
+	// Description:
+	// Function to set the number of frames in the pool.
+	// Frames that are in use by the consumers stay valid.
+	void setSize(const std::size_t size);
+	// Description:
+	// Function to get the number of frames in the pool.
+	auto getSize() const -> std::size_t;
+
+	// Description:
+	// Function to get a free frame buffer of the given size and type.
+	// It returns false if all the frames are still in use by the consumers,
+	// in that case nothing is allocated and frame is not changed.
+	auto acquire(const cv::Size& size, const int type, cv::Mat& frame) -> bool;
+
+	// Description:
+	// Function that returns the number of frames that are not in use.
+	auto available() const -> std::size_t;
+
+	// Description:
+	// Function to release all the frame buffers of the pool.
+	// Frames that are in use by the consumers stay valid.
+	void clear();
+
+private:
+	// Description:
+	// Function that returns true if the pool owns the only reference to the frame.
+	static auto isFree(const cv::Mat& m) -> bool;
+
+	mutable std::mutex m_mutex;
+	std::vector<cv::Mat> m_frames;
+	std::size_t m_next;
+};
+
+}
+
+#endif // fvkFramePool_h__
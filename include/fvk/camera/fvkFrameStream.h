@@ -0,0 +1,207 @@
+#pragma once
+#ifndef fvkFrameStream_h__
+#define fvkFrameStream_h__
+
+/*********************************************************************************
+created:	2026/10/18   06:20PM
+filename: 	fvkFrameStream.h
+file base:	fvkFrameStream
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	asynchronous stream of the grabbed frames of a camera, for consumers that
+do not want to block a thread per camera (or run on the processing thread).
+A stream reads one subscriber buffer of the camera (see fvkCamera::subscribe()), and
+hands the next frame to a function that is executed on an executor of the caller's
+choice, so hundreds of streams can be served by a few event-loop threads.
+When compiled as C++20, the next frame can also be awaited in a coroutine.
+An empty frame means that the stream has ended (the camera was disconnected).
+
+usage example:
+--------------
+
+fvkExecutor loop(2);
+auto stream = cam.frameStream(1, fvkBufferPolicy::DropOldest);
+stream.asyncNext(loop, [](fvkFrame frame) { ... });	// on a thread of loop.
+
+// C++20:
+auto consume(fvkCamera& cam, fvkExecutor& loop) -> task
+{
+	while (true)
+	{
+		auto frame = co_await cam.nextFrame(loop);	// resumes on a thread of loop.
+		if (frame.empty()) break;
+		...
+	}
+}
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkBroadcastBuffer.h"
+#include "fvkExecutor.h"
+#include "fvkFrame.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define FVK_HAS_COROUTINES 1
+#endif
+#endif
+
+namespace R3D
+{
+
+// Description:
+// Function that executes a task on the executor of the caller's choice,
+// for example [&loop](std::function<void()> task) { loop.post(std::move(task)); }.
+using fvkPostFunc = std::function<void(std::function<void()>)>;
+
+class fvkFrameAwaiter;
+
+class FVK_CAMERA_EXPORT fvkFrameStream
+{
+public:
+	using Subscriber = fvkBroadcastBuffer<fvkFrame>::Subscriber;
+
+	// Description:
+	// Default constructor that creates a stream without any buffer, it ends right away.
+	fvkFrameStream() = default;
+	// Description:
+	// Constructor that creates a stream of the frames that are put into the given buffer.
+	explicit fvkFrameStream(Subscriber buffer) : m_buffer(std::move(buffer)) {}
+
+	// Description:
+	// Function that calls f with the next frame, f is executed by post (see fvkPostFunc).
+	// If a frame is available already, f is posted right away, otherwise it is posted by
+	// the camera thread when the next frame arrives. Only one call should wait at a time.
+	void asyncNext(fvkPostFunc post, std::function<void(fvkFrame)> f) const
+	{
+		waitNext(m_buffer, std::move(post), std::move(f));
+	}
+	// Description:
+	// Function that calls f with the next frame on a worker of the given executor.
+	// The executor must outlive the call of f.
+	void asyncNext(fvkExecutor& executor, std::function<void(fvkFrame)> f) const
+	{
+		asyncNext(postTo(executor), std::move(f));
+	}
+	// Description:
+	// Function that takes the next frame if it is available already without waiting.
+	// It returns false if there is none.
+	auto tryNext(fvkFrame& frame) const -> bool
+	{
+		return m_buffer && m_buffer->try_get(frame);
+	}
+
+	// Description:
+	// Function that returns an awaitable of the next frame, the awaiting coroutine is
+	// resumed by post (or on the given executor). See fvkFrameAwaiter.
+	auto next(fvkPostFunc post) const -> fvkFrameAwaiter;
+	auto next(fvkExecutor& executor) const -> fvkFrameAwaiter;
+
+	// Description:
+	// Function that returns the buffer of this stream.
+	auto buffer() const -> const Subscriber& { return m_buffer; }
+
+	// Description:
+	// Function that returns a post function that executes the task on a worker of the given executor.
+	static auto postTo(fvkExecutor& executor) -> fvkPostFunc
+	{
+		return [&executor](std::function<void()> task) { executor.post(std::move(task)); };
+	}
+
+private:
+	static void waitNext(const Subscriber& buffer, fvkPostFunc post, std::function<void(fvkFrame)> f)
+	{
+		if (!buffer)
+		{
+			post([f]() { f(fvkFrame()); });
+			return;
+		}
+
+		buffer->notifyWhenReadable([buffer, post, f]()
+		{
+			// the frame is taken on the executor, the camera thread only posts the task.
+			post([buffer, post, f]()
+			{
+				fvkFrame frame;
+				if (buffer->try_get(frame) || buffer->isClosed())
+					f(std::move(frame));
+				else
+					waitNext(buffer, post, f);	// taken by another consumer meanwhile.
+			});
+		});
+	}
+
+	Subscriber m_buffer;
+};
+
+// Description:
+// Awaitable of the next frame of a fvkFrameStream, co_await returns the frame (empty when
+// the stream has ended). If a frame is available already, the coroutine just continues,
+// otherwise it is resumed by the post function when the next frame arrives.
+// It is only awaitable in C++20 (FVK_HAS_COROUTINES), but it is declared the same way in
+// every translation unit, await_suspend() takes any coroutine handle, so the classes do
+// not depend on the language version that includes them.
+class FVK_CAMERA_EXPORT fvkFrameAwaiter
+{
+public:
+	fvkFrameAwaiter(const fvkFrameStream& stream, fvkPostFunc post) :
+		m_stream(stream),
+		m_post(std::move(post))
+	{
+	}
+
+	auto await_ready() -> bool
+	{
+		return m_stream.tryNext(m_frame);
+	}
+	template <typename _Handle>
+	void await_suspend(_Handle h)
+	{
+		// the coroutine can be resumed on another thread before this call returns,
+		// so this awaiter must not be touched after asyncNext().
+		m_stream.asyncNext(std::move(m_post), [this, h](fvkFrame frame)
+		{
+			m_frame = std::move(frame);
+			h.resume();
+		});
+	}
+	auto await_resume() -> fvkFrame
+	{
+		return std::move(m_frame);
+	}
+
+private:
+	fvkFrameStream m_stream;
+	fvkPostFunc m_post;
+	fvkFrame m_frame;
+};
+
+inline auto fvkFrameStream::next(fvkPostFunc post) const -> fvkFrameAwaiter
+{
+	return fvkFrameAwaiter(*this, std::move(post));
+}
+inline auto fvkFrameStream::next(fvkExecutor& executor) const -> fvkFrameAwaiter
+{
+	return fvkFrameAwaiter(*this, postTo(executor));
+}
+
+}
+
+#endif // fvkFrameStream_h__
@@ -0,0 +1,79 @@
+#pragma once
+#ifndef fvkFutex_h__
+#define fvkFutex_h__
+
+/*********************************************************************************
+created:	2026/10/18   02:05PM
+filename: 	fvkFutex.h
+file base:	fvkFutex
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	parking primitives for the semaphores: a thread can sleep until an atomic
+integer changes its value, and be woken by the thread that changes it.
+On Linux, it is a futex on the integer itself, so a wake without any parked thread
+costs nothing and a wake only wakes the requested number of threads.
+On the other platforms, the threads are parked on a small table of mutexes and
+condition variables, indexed by the address of the integer.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <atomic>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkFutex
+{
+public:
+	// Description:
+	// Function that parks the calling thread as long as word is equal to expected,
+	// until wake() is called for word, or until the given nanoseconds are elapsed
+	// (a negative value waits forever). It can also return spuriously, so the caller
+	// has to check word again. It returns false on timeout.
+	static auto wait(std::atomic<int>& word, const int expected, const long long nanoseconds = -1) -> bool;
+	// Description:
+	// Function that wakes up to n threads (all of them if n <= 0) that are parked on word.
+	// word must be changed before calling this function.
+	static void wake(std::atomic<int>& word, const int n = 1);
+
+	// Description:
+	// Function that tells the CPU that the thread is spinning (pause instruction).
+	static void pause();
+	// Description:
+	// Function that returns the number of times a semaphore spins on its counter before
+	// parking the thread, 100 pause instructions (a few microseconds at most).
+	// It is zero on a single core machine, where spinning only delays
+	// the thread that would change the counter.
+	static auto spinCount() -> int;
+	// Description:
+	// Function that calls f until it returns true, for at most spinCount() times.
+	// It returns true as soon as f returns true.
+	template <typename _F>
+	static auto spin(_F&& f) -> bool
+	{
+		const auto n = spinCount();
+		for (auto i = 0; i < n; i++)
+		{
+			if (f())
+				return true;
+			pause();
+		}
+		return false;
+	}
+};
+
+}
+
+#endif // fvkFutex_h__
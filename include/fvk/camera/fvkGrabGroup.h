@@ -0,0 +1,145 @@
+#pragma once
+#ifndef fvkGrabGroup_h__
+#define fvkGrabGroup_h__
+
+/*********************************************************************************
+created:	2026/10/18   10:40PM
+filename: 	fvkGrabGroup.h
+file base:	fvkGrabGroup
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	group of camera threads that grab their frames at the same instant.
+Every camera thread of the group waits at a barrier until all of them are ready, then
+they all latch the next frame of their device at once (cv::VideoCapture::grab(), the
+V4L2 dequeue), and each one retrieves (decodes) its own frame afterwards on its own
+thread, in parallel. A camera thread that does not split its grab into latch() and
+retrieve() decodes within the latch, so its decoding time adds to the skew of the set.
+The frames of the same grab are collected into a frame set, which is handed to the
+frame set output as soon as the last camera of the group has delivered its frame.
+A camera that does not arrive in time (stalled, paused or disconnected) does not hold
+the others: the barrier is released after the timeout without it.
+The cameras of a group need their own threads, they should not be started on an executor.
+
+usage example:
+--------------
+
+fvkCameraList<fvkCamera> list;
+list.add(0);
+list.add(1);
+list.setGrabSyncEnabled(true);
+list.getGrabGroup()->setFrameSetOutput([](std::vector<fvkFrame>& set)
+{
+	// set[i].capture_time of all the frames are within a fraction of a millisecond.
+});
+list.start();
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+#include "fvkFrame.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkGrabGroup
+{
+public:
+	// Description:
+	// Default constructor that creates an empty group.
+	fvkGrabGroup();
+	// Description:
+	// Default destructor.
+	virtual ~fvkGrabGroup() = default;
+
+	fvkGrabGroup(const fvkGrabGroup&) = delete;
+	fvkGrabGroup& operator=(const fvkGrabGroup&) = delete;
+
+	// Description:
+	// Function to set the time in milliseconds that a camera waits at the barrier for the others,
+	// after that the cameras that have arrived grab without the missing ones. Default is 1000.
+	void setTimeout(const int ms) { m_timeout = ms; }
+	// Description:
+	// Function to get the time in milliseconds that a camera waits at the barrier for the others.
+	auto getTimeout() const -> int { return m_timeout; }
+
+	// Description:
+	// Function to set the function that receives the frame sets, sorted by the camera index.
+	// It is called on the thread of the camera that has delivered the last frame of the set,
+	// so it should return quickly. A set holds fewer frames than the group has cameras when
+	// a camera has missed the grab or could not retrieve its frame.
+	void setFrameSetOutput(const std::function<void(std::vector<fvkFrame>&)> f);
+
+	// Description:
+	// Function that returns the number of the camera threads that are running in this group.
+	auto getMembers() const -> std::size_t;
+	// Description:
+	// Function that returns the number of the frame sets that held the frames of all the cameras.
+	auto getCompleteSets() const -> unsigned long long { return m_ncomplete; }
+	// Description:
+	// Function that returns the number of the frame sets that missed the frame of one camera or more.
+	auto getIncompleteSets() const -> unsigned long long { return m_nincomplete; }
+	// Description:
+	// Function that returns the time in milliseconds between the first and the last capture
+	// of the last frame set.
+	auto getLastSkew() const -> double { return m_skew; }
+
+	// Description:
+	// Functions that are called by a camera thread when it starts and when it stops.
+	void join();
+	void leave();
+	// Description:
+	// Function that is called by a camera thread before it grabs. It waits until all the cameras
+	// of the group have arrived (or until the timeout), and gives the number of the frame set of
+	// this grab. It returns false without a set if cancel() returns true while it waits.
+	auto arrive(std::uint64_t& set, const std::function<bool()>& cancel) -> bool;
+	// Description:
+	// Function that is called by a camera thread with its frame of the given set after it has
+	// retrieved it, an empty frame if it could not.
+	void deliver(const std::uint64_t set, fvkFrame frame);
+
+private:
+	struct FrameSet
+	{
+		std::size_t members;			// number of cameras in the group when the set was released.
+		std::size_t expected;			// number of cameras that have grabbed for this set.
+		std::size_t ndelivered;
+		std::vector<fvkFrame> frames;
+	};
+
+	// release the cameras that are waiting for the current set.
+	void release();
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::size_t m_members;
+	std::size_t m_arrived;				// cameras that are waiting for the current set.
+	std::uint64_t m_set;				// number of the current set.
+	std::map<std::uint64_t, FrameSet> m_sets;	// released sets that wait for their frames.
+	std::function<void(std::vector<fvkFrame>&)> m_output_func;
+	std::atomic<int> m_timeout;
+	std::atomic<unsigned long long> m_ncomplete;
+	std::atomic<unsigned long long> m_nincomplete;
+	std::atomic<double> m_skew;
+};
+
+}
+
+#endif // fvkGrabGroup_h__
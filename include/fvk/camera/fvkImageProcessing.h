@@ -23,6 +23,7 @@ purpose:	class to do some basic image processing.
 **********************************************************************************/
 
 #include "fvkFaceDetector.h"
+#include "fvkFramePool.h"
 
 #include "opencv2/opencv.hpp"
 #include <mutex>
@@ -420,7 +421,15 @@ public:
 
 	// Description:
 	// Function to perform image processing algorithms.
+	// The data of the given frame is not modified, since it is shared with the other consumers of the
+	// camera, the frame is replaced by the processed one (a private copy when a filter works in place).
 	virtual void imageProcessing(cv::Mat& frame);
+	// Description:
+	// Function to get a reference to the pool of the output frames of the zoom, flip, rotation,
+	// negative and in-place filters. The pool size should be at least the processed frames that are
+	// in flight (processed, displayed or kept by the consumers) plus two for a chain of filters,
+	// when all the pooled frames are in use, a filter allocates a new output frame.
+	auto& framePool() { return m_pool; }
 
 private:
 	int m_denoislevel;
@@ -454,7 +463,10 @@ private:
 	bool m_isfacetrack;
 	fvkSimpleFaceDetector m_ft;
 
+	fvkFramePool m_pool;	// recycled output frames of the zoom, flip, rotation and negative filters.
+
 	std::mutex m_mutex;
+	std::mutex m_ftmutex;	// the face tracker keeps its state from one frame to the next.
 };
 
 }
@@ -0,0 +1,102 @@
+#pragma once
+#ifndef fvkJThread_h__
+#define fvkJThread_h__
+
+/*********************************************************************************
+created:	2026/10/18   03:35PM
+filename: 	fvkJThread.h
+file base:	fvkJThread
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	owned, joinable thread with a stop token, like std::jthread of C++20.
+The thread function gets a fvkStopToken, and the destructor requests the stop and
+joins the thread, so a thread can never outlive its owner or be leaked.
+
+usage example:
+--------------
+
+fvkJThread th([](const fvkStopToken& token)
+{
+	while (!token.stop_requested()) { ... }
+});
+th.request_stop();
+th.join();		// or just let th go out of scope.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkStopToken.h"
+
+#include <functional>
+#include <thread>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkJThread
+{
+public:
+	// Description:
+	// Default constructor that creates an object without a thread.
+	fvkJThread() = default;
+	// Description:
+	// Constructor that starts a new thread executing func with a token of a new stop source.
+	explicit fvkJThread(std::function<void(const fvkStopToken&)> func);
+	// Description:
+	// Constructor that starts a new thread executing func with a token of the given stop source,
+	// so several threads can be stopped by one request.
+	fvkJThread(const fvkStopSource& source, std::function<void(const fvkStopToken&)> func);
+	// Description:
+	// Destructor that requests the stop and joins the thread.
+	~fvkJThread();
+
+	// Description:
+	// Move constructor and assignment, the thread of this object (if any) is
+	// stopped and joined before it takes the other thread.
+	fvkJThread(fvkJThread&& other) noexcept;
+	fvkJThread& operator=(fvkJThread&& other) noexcept;
+	// Description:
+	// Non-implemented.
+	fvkJThread(const fvkJThread&) = delete;
+	fvkJThread& operator=(const fvkJThread&) = delete;
+
+	// Description:
+	// Function that returns true if there is a thread that has not been joined yet.
+	auto joinable() const -> bool { return m_thread.joinable(); }
+	// Description:
+	// Function that blocks until the thread has finished.
+	void join();
+	// Description:
+	// Function that requests the stop of the thread. It returns false if it has been requested already.
+	auto request_stop() -> bool { return m_source.request_stop(); }
+	// Description:
+	// Function that returns the stop source of the thread.
+	auto get_stop_source() const -> fvkStopSource { return m_source; }
+	// Description:
+	// Function that returns a stop token of the thread.
+	auto get_stop_token() const -> fvkStopToken { return m_source.get_token(); }
+
+	// Description:
+	// Function that returns the id of the thread.
+	auto get_id() const -> std::thread::id { return m_thread.get_id(); }
+	// Description:
+	// Function that returns the native handle of the thread.
+	auto native_handle() -> std::thread::native_handle_type { return m_thread.native_handle(); }
+
+private:
+	fvkStopSource m_source;
+	std::thread m_thread;
+};
+
+}
+
+#endif // fvkJThread_h__
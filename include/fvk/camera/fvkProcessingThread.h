@@ -24,10 +24,19 @@ camera frame. This thread is synchronized with the camera thread using a semapho
 * If not, please contact Dr. Furqan Ullah immediately:
 **********************************************************************************/
 
+#include "fvkFrame.h"
 #include "fvkImageProcessing.h"
 #include "fvkSemaphoreBuffer.h"
+#include "fvkTripleBuffer.h"
 #include "fvkVideoWriter.h"
 #include "fvkThread.h"
+#include "fvkJThread.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace R3D
 {
@@ -42,12 +51,12 @@ public:
 	// _device_index is the id of the opened video capturing device (i.e. a camera index).
 	// _frameobserver is the parent class of Camera that will override the present function.
 	// _buffer is the semaphore to synchronize the camera thread with this thread.
-	fvkProcessingThread(const int device_index, fvkCameraAbstract* frameobserver, fvkSemaphoreBuffer<cv::Mat>* buffer = nullptr);
+	fvkProcessingThread(const int device_index, fvkCameraAbstract* frameobserver, fvkSemaphoreBuffer<fvkFrame>* buffer = nullptr);
 	// Description:
 	// Default constructor to create a synchronized processing thread.
 	// _device_index is the id of the opened video capturing device (i.e. a camera index).
 	// _buffer is the semaphore to synchronize the camera thread with this thread.
-	explicit fvkProcessingThread(const int device_index, fvkSemaphoreBuffer<cv::Mat>* buffer = nullptr);
+	explicit fvkProcessingThread(const int device_index, fvkSemaphoreBuffer<fvkFrame>* buffer = nullptr);
 	// Description:
 	// Default destructor to stop the thread as well as recorder, and delete the data.
 	virtual ~fvkProcessingThread();
@@ -89,11 +98,57 @@ public:
 	// The display function should be capable of handling multi-threading updating.
 	// The second argument which is fvkThreadStats will give you statistics of the thread,
 	// such as Average frames per second (FPS) and number of processed frames.
+	// The frame comes with its capture time, sequence number and camera index (see fvkFrame),
+	// so the latency from the capture to the output is frame.age().
+	void setVideoOutput(const std::function<void(fvkFrame&, const fvkThreadStats&)> f);
+	// Description:
+	// Set a GUI function to display the processed frame, it only gets the image of the frame.
 	void setVideoOutput(const std::function<void(cv::Mat&, const fvkThreadStats&)> f);
 
+	// Description:
+	// Function to get the most recently processed frame without blocking this thread or the caller.
+	// It is meant to be called by a GUI timer at its own refresh rate, so painting never
+	// slows down the processing. Only one thread should call this function.
+	// It returns true if a new frame has been processed since the last call,
+	// otherwise frame is the same as in the last call.
+	// The frame is shared with the processing thread, it should not be modified (clone it first).
+	auto getLatestFrame(cv::Mat& frame) -> bool { return m_mailbox.read(frame); }
+	// Description:
+	// Function that returns the number of processed frames that the mailbox of getLatestFrame()
+	// keeps at most, they are not given back to the frame pool before newer frames replace them.
+	static constexpr auto getMailboxSize() -> std::size_t { return 3; }
+
+	// Description:
+	// Function to set the number of frames that are processed together (batch mode).
+	// With n > 1, the thread takes up to n frames at once from the buffer and hands them
+	// to presentBatch(), it waits for at most the given milliseconds for a full batch.
+	// The buffer capacity should be at least n, otherwise the batch is limited to the capacity.
+	// In batch mode, the thread statistics count batches instead of frames.
+	// Default is 1 (no batch mode, every frame is handed to present()).
+	void setBatchSize(const std::size_t n, const unsigned long milliseconds = 100) { m_batch_timeout = milliseconds; m_batch_size = n > 0 ? n : 1; }
+	// Description:
+	// Function to get the number of frames that are processed together.
+	auto getBatchSize() const -> std::size_t { return m_batch_size; }
+	// Description:
+	// Function to set the number of workers that process the frames at the same time.
+	// With n > 1, n worker threads take the frames (or batches) from the buffer and run the
+	// image processing concurrently, and this thread puts the processed frames back in the
+	// order they were captured before present(), the video output and the recording.
+	// So a heavy filter chain scales with the cores, the output is never reordered, and
+	// present() is still called on one thread. The workers are added to this thread, they
+	// are started and stopped with it.
+	// The workers take the frames from the buffer concurrently, so n > 1 needs the
+	// fvkBufferBackend::Queue backend: with fvkBufferBackend::SpscRing (one consumer only) the call
+	// is refused and returns false, and a run with that backend is processed by this thread alone.
+	// Default is 1 (the processing is done by this thread). This should be called before the start() function.
+	auto setWorkerCount(const std::size_t n) -> bool;
+	// Description:
+	// Function to get the number of workers that process the frames at the same time.
+	auto getWorkerCount() const -> std::size_t { return m_nworkers; }
+
 	// Description:
 	// Function to set a pointer to semaphore buffer which does synchronization between capturing and processing threads.
-	void setSemaphoreBuffer(fvkSemaphoreBuffer<cv::Mat>* p) { p_buffer = p; }
+	void setSemaphoreBuffer(fvkSemaphoreBuffer<fvkFrame>* p) { p_buffer = p; }
 	// Description:
 	// Function to get a pointer to semaphore buffer which does synchronization between capturing and processing threads.
 	auto getSemaphoreBuffer() const { return p_buffer; }
@@ -106,7 +161,17 @@ public:
 	// Function to get a reference to image processing.
 	auto& imageProcessing() { return m_ip; }
 
+	// Description:
+	// Overridden function that returns false while there is no frame to process, so an
+	// executor does not block its thread in get().
+	auto ready() -> bool override;
+
 protected:
+	// Description:
+	// Overridden functions that start and stop the workers (see setWorkerCount()).
+	void onStart() override;
+	void onStop() override;
+
 	// Description:
 	// Overridden function to process the camera frame.
 	void run() override;
@@ -115,6 +180,29 @@ protected:
 	// Virtual function that is expected to be overridden in the derived class in order
 	// to process the captured frame.
 	virtual void present(cv::Mat& frame);
+	// Description:
+	// Virtual function that can be overridden instead of present(cv::Mat&) in order to
+	// process the captured frame together with its capture information (see fvkFrame).
+	// By default, it calls present() with the image of the frame.
+	virtual void present(fvkFrame& frame);
+	// Description:
+	// Virtual function that is expected to be overridden in the derived class in order
+	// to process a batch of captured frames in one pass (see setBatchSize()).
+	// The frames are in the order they were captured.
+	// By default, it calls present() for every frame.
+	virtual void presentBatch(std::vector<fvkFrame>& frames);
+
+	// Description:
+	// Function that hands the processed frames to the observer, present() (or presentBatch())
+	// and the outputs, in the order they are given.
+	void deliver(std::vector<fvkFrame>& frames);
+	// Description:
+	// Function that hands the processed frame to the outputs (video output, display, disk and recorder).
+	void output(fvkFrame& frame);
+	// Description:
+	// Function that a worker executes until it is stopped: it takes the next frames with their
+	// sequence number, processes them and hands them to the reordering.
+	void work(const fvkStopToken& token, const std::size_t nworkers);
 
 	// Description:
 	// Function that saves the current frame to disk (file path must be specified by setSavedFile("")).
@@ -124,15 +212,32 @@ protected:
 	// protected member variables.
 	fvkCameraAbstract *p_frameobserver;
 	std::mutex m_processing_mutex;
-	fvkSemaphoreBuffer<cv::Mat> *p_buffer;
-	std::function<void(cv::Mat&, const fvkThreadStats&)> m_video_output_func;
+	fvkSemaphoreBuffer<fvkFrame> *p_buffer;
+	std::function<void(fvkFrame&, const fvkThreadStats&)> m_video_output_func;
 
 	fvkImageProcessing m_ip;
 	fvkVideoWriter m_vr;
+	fvkTripleBuffer<cv::Mat> m_mailbox;	// latest processed frame for the display.
 
 	int m_device_index;
 	std::string m_filepath;
 	std::atomic<bool> m_save;
+	std::atomic<std::size_t> m_batch_size;
+	std::atomic<unsigned long> m_batch_timeout;
+	std::vector<fvkFrame> m_batch;
+
+	// workers and reordering (see setWorkerCount()).
+	std::atomic<std::size_t> m_nworkers;
+	std::vector<fvkJThread> m_workers;
+	fvkStopSource m_workers_stop;
+	std::mutex m_pullmutex;			// a worker takes the frames and their sequence number at once.
+	std::uint64_t m_pullseq;		// sequence number of the next frames taken from the buffer.
+	std::mutex m_ordermutex;
+	std::condition_variable m_ordercond;
+	std::map<std::uint64_t, std::vector<fvkFrame>> m_reorder;	// processed frames that wait for their turn.
+	std::uint64_t m_nextseq;		// sequence number of the next frames to deliver.
+	std::size_t m_nactive;			// number of workers that have not left.
+	std::atomic<bool> m_parallel;	// the workers are running, set by onStart() and onStop().
 };
 
 }
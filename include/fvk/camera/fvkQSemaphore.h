@@ -12,6 +12,9 @@ website:    http://real3d.pk
 CopyRight:	All Rights Reserved
 
 purpose:	basic semaphore like QSemaphore functionalities.
+The count is an atomic integer, acquire() spins on it for a few microseconds
+before the thread is parked (futex on Linux), and release(n) only wakes up to n
+parked threads.
 
 /**********************************************************************************
 *	Fast Visualization Kit (FVK)
@@ -24,8 +27,7 @@ purpose:	basic semaphore like QSemaphore functionalities.
 
 #include "fvkCameraExport.h"
 
-#include <condition_variable>
-#include <mutex>
+#include <atomic>
 
 namespace R3D
 {
@@ -60,9 +62,9 @@ public:
 	auto count() -> int;
 
 private:
-	std::mutex m_mutex;
-	std::condition_variable m_cv;
-	int m_count;
+	std::atomic<int> m_count;
+	std::atomic<int> m_waiters;			// number of parked threads.
+	std::atomic<int> m_multi_waiters;	// number of parked threads that acquire more than one count.
 };
 
 }
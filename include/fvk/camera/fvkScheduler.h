@@ -0,0 +1,171 @@
+#pragma once
+#ifndef fvkScheduler_h__
+#define fvkScheduler_h__
+
+/*********************************************************************************
+created:	2026/10/18   07:05PM
+filename: 	fvkScheduler.h
+file base:	fvkScheduler
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	single-thread scheduler of periodic tasks for the auxiliary jobs
+(statistics refresh, periodic snapshots, health checks, ...), so a low-rate job
+does not cost a full thread that loops on a fixed delay.
+The deadlines of all the tasks are kept in one priority queue on the steady clock,
+the thread sleeps until the earliest deadline and runs the due tasks one by one.
+Every task has its own period on a fixed grid (a late run does not shift the next
+deadlines), the periods that are completely missed are skipped and counted.
+How late every run started (jitter) is recorded per task, see fvkTaskStats.
+
+usage example:
+--------------
+
+fvkScheduler scheduler;
+auto id = scheduler.schedule(std::chrono::seconds(1), [&]() { std::cout << cam.getAvgFps() << "\n"; });
+...
+std::cout << scheduler.getStats(id).percentile(99) << " us\n";
+scheduler.cancel(id);
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkBufferStats.h"
+#include "fvkJThread.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace R3D
+{
+
+// Description:
+// Statistics of a periodic task of fvkScheduler.
+// The jitter of a run is the time from its deadline until it really started.
+class FVK_CAMERA_EXPORT fvkTaskStats
+{
+public:
+	fvkTaskStats() :
+		nruns(0),
+		nmissed(0),
+		mean_jitter(0),
+		max_jitter(0)
+	{
+		jitter.fill(0);
+	}
+
+	std::uint64_t nruns;				// number of runs of the task.
+	std::uint64_t nmissed;				// number of periods that were skipped because the task was too late.
+	double mean_jitter;					// average jitter in microseconds.
+	long long max_jitter;				// maximum jitter in microseconds.
+	std::array<std::uint64_t, fvkBufferStats::nbuckets> jitter;	// histogram of the jitter (see fvkBufferStats::bucket()).
+
+	// Description:
+	// Function that returns the jitter (upper limit in microseconds) that p percent (0 to 100)
+	// of the runs did not exceed, 0 if the task has not run yet.
+	auto percentile(const double p) const -> long long
+	{
+		return fvkBufferStats::percentile(jitter, p);
+	}
+};
+
+class FVK_CAMERA_EXPORT fvkScheduler
+{
+public:
+	using Task = std::function<void()>;
+	using TimePoint = std::chrono::steady_clock::time_point;
+	using Duration = std::chrono::steady_clock::duration;
+
+	// Description:
+	// Constructor that starts the thread of the scheduler.
+	fvkScheduler();
+	// Description:
+	// Destructor that stops and joins the thread, a task that is being executed finishes its run.
+	~fvkScheduler();
+
+	// Description:
+	// Non-implemented.
+	fvkScheduler(const fvkScheduler&) = delete;
+	fvkScheduler& operator=(const fvkScheduler&) = delete;
+
+	// Description:
+	// Function to add a task that is executed every period, the first time after the period.
+	// It returns the id of the task, that is used to cancel it or to get its statistics.
+	// The tasks run one after the other on the thread of the scheduler, so a task should
+	// not block, a long task delays (adds jitter to) the other tasks.
+	auto schedule(const Duration& period, Task task) -> std::size_t;
+	// Description:
+	// Function to add a task that is executed every period, the first time at the given time.
+	auto schedule(const TimePoint& first, const Duration& period, Task task) -> std::size_t;
+	// Description:
+	// Function to add a task that is executed once after the given delay.
+	auto scheduleOnce(const Duration& delay, Task task) -> std::size_t;
+	// Description:
+	// Function to remove a task. It returns false if there is no task with the given id.
+	// If the task is being executed on the scheduler thread, it waits until the run has
+	// finished (unless it is called by the task itself), so whatever the task uses can be
+	// destroyed after this call.
+	auto cancel(const std::size_t id) -> bool;
+	// Description:
+	// Function to change the period of a task, the next run is one new period after the last
+	// deadline. It returns false if there is no task with the given id.
+	auto setPeriod(const std::size_t id, const Duration& period) -> bool;
+
+	// Description:
+	// Function that returns the statistics of a task (empty if there is no task with the given id).
+	auto getStats(const std::size_t id) const -> fvkTaskStats;
+	// Description:
+	// Function that returns the number of scheduled tasks.
+	auto size() const -> std::size_t;
+
+	// Description:
+	// Function that returns the scheduler thread (to set its affinity or priority).
+	auto native_handle() { return m_thread.native_handle(); }
+
+private:
+	struct Job
+	{
+		Task task;
+		Duration period;		// zero for a task that runs once.
+		TimePoint deadline;
+		fvkTaskStats stats;
+	};
+	struct Entry
+	{
+		TimePoint time;
+		std::size_t id;
+		auto operator<(const Entry& other) const -> bool { return time > other.time; }	// earliest first.
+	};
+
+	auto add(const TimePoint& first, const Duration& period, Task task) -> std::size_t;
+	void work(const fvkStopToken& token);
+
+	mutable std::mutex m_mutex;			// protects the jobs and the queue.
+	std::condition_variable m_cond;
+	std::condition_variable m_donecond;	// notified when a task has finished its run.
+	std::size_t m_running;				// id of the task that is being executed, 0 if none.
+	std::priority_queue<Entry> m_queue;
+	std::unordered_map<std::size_t, std::shared_ptr<Job>> m_jobs;
+	std::size_t m_next_id;
+	fvkJThread m_thread;				// created last, it uses all the members above.
+};
+
+}
+
+#endif // fvkScheduler_h__
@@ -12,6 +12,9 @@ website:    http://real3d.pk
 CopyRight:	All Rights Reserved
 
 purpose:	class for a basic semaphore like functionalities.
+The count is an atomic integer, so notify() and try_wait() never take a lock.
+wait() spins on the count for a few microseconds before the thread is parked
+(futex on Linux), and notify() only wakes one parked thread, if there is one.
 
 /**********************************************************************************
 *	Fast Visualization Kit (FVK)
@@ -24,6 +27,7 @@ purpose:	class for a basic semaphore like functionalities.
 
 #include "fvkCameraExport.h"
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 
@@ -46,7 +50,8 @@ public:
 
 	// Description:
 	// Function that blocks the thread, until get notify by calling notify() method.
-	void wait();
+	// It returns false if the semaphore is closed (see close()).
+	auto wait() -> bool;
 	// Description:
 	// This function does not block the thread, but wait until get notify by calling notify() method and returns true.
 	auto try_wait() -> bool;
@@ -55,8 +60,29 @@ public:
 	// it notifies to try_wait() method to unblock as well and return true to proceed.
 	void notify();
 
+	// Description:
+	// Function that takes up to max notifies at once without blocking the thread,
+	// and returns the number of notifies taken.
+	auto try_wait_many(const int max) -> int;
+	// Description:
+	// Function that gives count notifies at once, like calling notify() count times.
+	void notify(const int count);
+
+	// Description:
+	// Function that closes the semaphore, every waiting thread is woken up and every
+	// following wait returns false immediately, until the semaphore is reset.
+	void close();
+	// Description:
+	// Function that returns true if the semaphore is closed.
+	auto isClosed() const -> bool;
+	// Description:
+	// Function that opens the semaphore again with the given count.
+	// This should not be called while a thread waits on the semaphore.
+	void reset(const int count = 0);
+
 	// Description:
 	// Function that blocks the thread for the given milliseconds.
+	// It returns false on timeout or if the semaphore is closed.
 	auto wait_for(const unsigned long milliseconds) -> bool;
 	// Description:
 	// Function that blocks the thread from now to until the given milliseconds.
@@ -64,12 +90,19 @@ public:
 
 	// Description:
 	// Function that returns the condition variable native handle.
+	// The semaphore does not park the threads on this condition variable anymore,
+	// it is only kept for the compatibility.
 	auto native_handle() -> std::condition_variable::native_handle_type;
 
 protected:
-	std::mutex m_mutex;
+	// park the thread until the count is positive, or until the deadline (nanoseconds since
+	// the steady clock epoch, negative to wait forever). It returns false on timeout or close.
+	auto park(const long long deadline) -> bool;
+
 	std::condition_variable m_cv;
-	int m_count;
+	std::atomic<int> m_count;
+	std::atomic<int> m_waiters;		// number of parked threads.
+	std::atomic<bool> m_closed;
 };
 
 }
@@ -32,29 +32,470 @@ purpose:	creating a thread-safe synchronized queue and to achieve
 * If not, please contact Dr. Furqan Ullah immediately:
 **********************************************************************************/
 
+#include "fvkBufferStats.h"
 #include "fvkSemaphore.h"
+#include "fvkSpscRingBuffer.h"
+#include "fvkStopToken.h"
 
 #include <queue>
+#include <functional>
 #include <mutex>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <chrono>
 
 namespace R3D
 {
 
+// Description:
+// Storage backend of the semaphore buffer.
+// Queue is a mutex protected std::queue synchronized with two semaphores, any
+// number of threads can put and get.
+// SpscRing is a lock-free ring with preallocated slots that only parks a thread when
+// the ring is really empty or full. It requires exactly one producer (camera thread) and
+// one consumer (processing thread).
+enum class fvkBufferBackend
+{
+	Queue,
+	SpscRing
+};
+
+// Description:
+// What put() does when all the slots of the buffer are taken.
+// DropNewest discards the new item (the camera thread keeps running).
+// DropOldest discards the oldest queued item, so the buffer always keeps the freshest frames.
+// Block blocks the calling thread until the consumer takes an item.
+enum class fvkBufferPolicy
+{
+	DropNewest,
+	DropOldest,
+	Block
+};
+
 template <typename _T>
 class FVK_CAMERA_EXPORT fvkSemaphoreBuffer
 {
 public:
-	fvkSemaphoreBuffer() : m_sema_put(1), m_sema_get(0)
+	// Description:
+	// Default constructor that creates a buffer with one slot (one frame in flight).
+	explicit fvkSemaphoreBuffer(const fvkBufferBackend backend = fvkBufferBackend::Queue) : 
+		fvkSemaphoreBuffer(1, fvkBufferPolicy::DropNewest, backend)
 	{
 	}
-	fvkSemaphoreBuffer(const fvkSemaphoreBuffer& other)
+	// Description:
+	// Constructor that creates a buffer with the given number of slots and the policy
+	// that is applied when all the slots are taken.
+	fvkSemaphoreBuffer(const std::size_t capacity, const fvkBufferPolicy policy, const fvkBufferBackend backend = fvkBufferBackend::Queue) :
+		m_sema_put(0),
+		m_sema_get(0),
+		m_capacity(0),
+		m_policy(policy),
+		m_backend(backend),
+		m_closed(false),
+		m_nreadable(0)
 	{
-		std::lock_guard<std::mutex> lk(other.m_mutex);
-		m_data = other.m_data;
+		reset(capacity, backend);
 	}
+	// Description:
+	// Non-implemented.
+	fvkSemaphoreBuffer(const fvkSemaphoreBuffer&) = delete;
+	fvkSemaphoreBuffer& operator=(const fvkSemaphoreBuffer&) = delete;
 
+	// Description:
+	// Function to select the storage backend of this buffer.
+	// This should not be called when the threads are executed.
+	// Call it before executing the camera and processing threads.
+	// Items that are in the buffer are discarded when the backend is changed.
+	void setBackend(const fvkBufferBackend backend)
+	{
+		reset(m_capacity, backend);
+	}
+	// Description:
+	// Function to get the storage backend of this buffer.
+	auto getBackend() const { return m_backend; }
+
+	// Description:
+	// Function to set the maximum number of items (frames in flight) in this buffer.
+	// This should not be called when the threads are executed.
+	// Call it before executing the camera and processing threads.
+	// Items that are in the buffer are discarded when the capacity is changed.
+	void setCapacity(const std::size_t capacity)
+	{
+		reset(capacity, m_backend);
+	}
+	// Description:
+	// Function to get the maximum number of items in this buffer.
+	auto getCapacity() const { return m_capacity; }
+
+	// Description:
+	// Function to set what put() does when all the slots are taken.
+	// Default policy is fvkBufferPolicy::DropNewest.
+	void setPolicy(const fvkBufferPolicy policy) { m_policy = policy; }
+	// Description:
+	// Function to get what put() does when all the slots are taken.
+	auto getPolicy() const -> fvkBufferPolicy { return m_policy; }
+
+	// Description:
+	// Function to add an item to the buffer.
+	// If sync_and_block_thread is true, the calling thread is blocked while the buffer is full,
+	// otherwise the policy of this buffer decides what happens with a full buffer.
 	void put(const _T& item, const bool sync_and_block_thread = false)
 	{
+		push(sync_and_block_thread ? fvkBufferPolicy::Block : m_policy.load(), item);
+		notifyReadable();
+	}
+	// Description:
+	// Function to move an item into the buffer, so for cv::Mat the reference count
+	// of the frame is not touched.
+	void put(_T&& item, const bool sync_and_block_thread = false)
+	{
+		push(sync_and_block_thread ? fvkBufferPolicy::Block : m_policy.load(), std::move(item));
+		notifyReadable();
+	}
+	// Description:
+	// Function to construct an item in the buffer from the given arguments.
+	// The policy of this buffer decides what happens with a full buffer, and
+	// the item is not constructed at all if it is discarded (DropNewest).
+	template <typename... Args>
+	void emplace(Args&&... args)
+	{
+		push(m_policy.load(), std::forward<Args>(args)...);
+		notifyReadable();
+	}
+
+	// Description:
+	// Function to remove an item from the buffer.
+	// It blocks the calling thread until an item is available.
+	// The item is moved out of the buffer. If the buffer is closed, it returns an empty item.
+	_T get()
+	{
+		if (m_ring)
+		{
+			_T value;
+			if (!m_ring->try_get(value))
+			{
+				const auto t = fvkBufferCounters::now();
+				value = m_ring->get();
+				if (m_closed.load())
+					return _T();
+				m_stats.getWait(t);
+			}
+			m_stats.get();
+			return value;
+		}
+
+		if (!m_sema_get.try_wait())
+		{
+			const auto t = fvkBufferCounters::now();
+			if (!m_sema_get.wait())		// wait until you get notify from put() method.
+				return _T();			// buffer is closed.
+			m_stats.getWait(t);
+		}
+		m_stats.get();
+		m_mutex.lock();
+		_T value = std::move(m_data.front());	// protect the queue data and pop item.
+		m_data.pop();
+		m_mutex.unlock();
+		m_sema_put.notify();			// notify put() method to add item in the queue.
+		return value;
+	}
+	// Description:
+	// Function to remove an item from the buffer.
+	// It blocks the calling thread for at most the given milliseconds until an item
+	// is available, and returns false if no item arrived in that time (item is not changed).
+	// With 0 milliseconds, it never blocks. It returns false immediately if the buffer is closed.
+	auto try_get(_T& item, const unsigned long milliseconds = 0) -> bool
+	{
+		if (m_ring)
+		{
+			if (!m_ring->try_get(item))
+			{
+				const auto t = fvkBufferCounters::now();
+				if (!m_ring->try_get(item, milliseconds))
+					return false;
+				m_stats.getWait(t);
+			}
+			m_stats.get();
+			return true;
+		}
+
+		if (!m_sema_get.try_wait())
+		{
+			const auto t = fvkBufferCounters::now();
+			if (!m_sema_get.wait_for(milliseconds))
+				return false;
+			m_stats.getWait(t);
+		}
+		m_stats.get();
+		m_mutex.lock();
+		item = std::move(m_data.front());
+		m_data.pop();
+		m_mutex.unlock();
+		m_sema_put.notify();
+		return true;
+	}
+	// Description:
+	// Function to count an item that the producer has discarded without calling put(), because
+	// the buffer was full or there was no room to prepare it. It is counted as a dropped newest item.
+	void countDropNewest()
+	{
+		m_stats.dropNewest();
+	}
+	// Description:
+	// Function to discard the oldest item of the buffer, so whatever it refers to is freed before
+	// the producer puts a newer item (see fvkCameraThread::framePool()). It is counted as a dropped
+	// oldest item, and it returns false if the buffer is empty.
+	auto dropOldest() -> bool
+	{
+		if (m_ring)
+		{
+			if (!m_ring->discard_oldest())
+				return false;
+			m_stats.dropOldest();
+			return true;
+		}
+
+		if (!m_sema_get.try_wait())
+			return false;
+		m_mutex.lock();
+		auto item = std::move(m_data.front());
+		m_data.pop();
+		m_mutex.unlock();
+		m_stats.dropOldest();
+		m_sema_put.notify();
+		return true;
+	}
+
+	// Description:
+	// Function to remove up to max items from the buffer at once and append them to items.
+	// It blocks the calling thread for at most the given milliseconds until max items
+	// (or as many as the buffer can hold) are available, then all of them are taken
+	// out under a single lock. It returns the number of items appended, that can be
+	// less than max (or even zero) on timeout.
+	auto getBatch(std::vector<_T>& items, const std::size_t max, const unsigned long milliseconds = 0) -> std::size_t
+	{
+		if (max == 0)
+			return 0;
+		if (m_ring)
+		{
+			// a wait is only counted when the items that are there already are not enough.
+			auto k = m_ring->get_batch(items, max, 0);
+			if (k < (max < m_capacity ? max : m_capacity) && milliseconds > 0)
+			{
+				const auto t = fvkBufferCounters::now();
+				k += m_ring->get_batch(items, max - k, milliseconds);
+				m_stats.getWait(t);
+			}
+			m_stats.get(k);
+			return k;
+		}
+
+		const auto target = static_cast<int>(max < m_capacity ? max : m_capacity);
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+
+		// count the items first, without touching the queue.
+		auto n = 0;
+		auto waited = false;
+		auto t = 0LL;
+		while (n < target)
+		{
+			n += m_sema_get.try_wait_many(target - n);
+			if (n >= target)
+				break;
+
+			const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+			if (left <= 0)
+				break;
+			if (!waited)
+			{
+				waited = true;
+				t = fvkBufferCounters::now();
+			}
+			if (!m_sema_get.wait_for(static_cast<unsigned long>(left)))
+				break;
+			n++;
+		}
+		if (waited)
+			m_stats.getWait(t);
+		if (n == 0)
+			return 0;
+
+		m_stats.get(static_cast<std::size_t>(n));
+		m_mutex.lock();
+		for (auto i = 0; i < n; i++)
+		{
+			items.push_back(std::move(m_data.front()));
+			m_data.pop();
+		}
+		m_mutex.unlock();
+		m_sema_put.notify(n);			// notify put() method that n slots are free.
+		return static_cast<std::size_t>(n);
+	}
+	// Description:
+	// Function to remove up to max items from the buffer at once.
+	// See getBatch(items, max, milliseconds).
+	auto getBatch(const std::size_t max, const unsigned long milliseconds = 0) -> std::vector<_T>
+	{
+		std::vector<_T> items;
+		items.reserve(max < m_capacity ? max : m_capacity);
+		getBatch(items, max, milliseconds);
+		return items;
+	}
+
+	// Description:
+	// Function that closes the buffer, every thread that waits in put() or get() is woken up,
+	// and every following call returns immediately without an item (put() discards the item,
+	// get() returns an empty item, try_get() and getBatch() return nothing).
+	// It is used to stop the threads without waiting for one more frame.
+	void close()
+	{
+		m_closed.store(true);
+		if (m_ring)
+		{
+			m_ring->close();
+		}
+		else
+		{
+			m_sema_put.close();
+			m_sema_get.close();
+		}
+		notifyReadable();
+	}
+	// Description:
+	// Function that closes the buffer when the stop of the given token is requested, so a
+	// thread that waits in put() or get() is woken up by the stop request.
+	// It replaces the token of the previous call, an empty token removes it.
+	void closeOnStop(const fvkStopToken& token)
+	{
+		m_stop_cb.reset();
+		m_stop_cb.reset(new fvkStopCallback(token, [this]() { close(); }));
+	}
+	// Description:
+	// Function to call f once, as soon as an item can be taken or the buffer is closed.
+	// If that is the case already, f is called right away on the calling thread, otherwise
+	// it is called by the thread that puts the next item or closes the buffer, so f should
+	// only hand the work over (for example, post it to an executor) and not take the item
+	// itself. Another consumer can take the item first, so f may find the buffer empty.
+	void notifyWhenReadable(std::function<void()> f)
+	{
+		{
+			std::lock_guard<std::mutex> lk(m_readablemutex);
+			// counted before the buffer is checked, and put() adds the item before it reads
+			// the count, so either the item is seen here or put() sees the waiting function.
+			m_nreadable.fetch_add(1);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!m_closed.load() && empty())
+			{
+				m_readable.push_back(std::move(f));
+				return;
+			}
+			// never below zero, notifyReadable() may have reset the count meanwhile.
+			auto n = m_nreadable.load();
+			while (n > 0 && !m_nreadable.compare_exchange_weak(n, n - 1))
+			{
+			}
+		}
+		f();
+	}
+	// Description:
+	// Function that returns true if the buffer is closed.
+	auto isClosed() const -> bool { return m_closed.load(); }
+	// Description:
+	// Function that discards all the items and opens the buffer again (after close()).
+	// This should not be called when the threads are executed.
+	void reopen()
+	{
+		reset(m_capacity, m_backend);
+	}
+
+	// Description:
+	// Function that returns a snapshot of the statistics of this buffer (frames put,
+	// taken and dropped, wait times, occupancy), see fvkBufferStats.
+	auto getStats() const -> fvkBufferStats
+	{
+		return m_stats.snapshot(m_capacity);
+	}
+	// Description:
+	// Function that sets all the statistics of this buffer to zero.
+	// This should not be called when the threads are executed.
+	void resetStats()
+	{
+		m_stats.reset();
+	}
+
+	auto empty() const
+	{
+		if (m_ring)
+			return m_ring->empty();
+
+		std::lock_guard<std::mutex> lk(m_mutex);
+		return m_data.empty();
+	}
+	// Description:
+	// Function that returns true if all the slots are taken, meaning that a put() would
+	// block or drop an item. The producer can check it before preparing a new item.
+	auto full() const
+	{
+		if (m_ring)
+			return m_ring->full();
+
+		std::lock_guard<std::mutex> lk(m_mutex);
+		return m_data.size() >= m_capacity;
+	}
+
+private:
+	// call the functions that wait for an item (see notifyWhenReadable()).
+	void notifyReadable()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_nreadable.load() == 0)
+			return;
+
+		std::vector<std::function<void()>> fs;
+		{
+			std::lock_guard<std::mutex> lk(m_readablemutex);
+			fs.swap(m_readable);
+			m_nreadable = 0;
+		}
+		for (auto& f : fs)
+			f();
+	}
+
+	// add an item constructed from args according to the given policy.
+	template <typename... Args>
+	void push(const fvkBufferPolicy policy, Args&&... args)
+	{
+		if (m_closed.load())
+			return;
+
+		if (m_ring)
+		{
+			if (policy == fvkBufferPolicy::DropOldest)
+			{
+				m_stats.put(m_ring->emplace_overwrite(std::forward<Args>(args)...));
+			}
+			else if (m_ring->emplace(false, std::forward<Args>(args)...))	// args are only used if there is a free slot.
+			{
+				m_stats.put();
+			}
+			else if (policy == fvkBufferPolicy::Block)
+			{
+				const auto t = fvkBufferCounters::now();
+				if (!m_ring->emplace(true, std::forward<Args>(args)...))
+					return;				// buffer is closed.
+				m_stats.putWait(t);
+				m_stats.put();
+			}
+			else
+			{
+				m_stats.dropNewest();
+			}
+			return;
+		}
+
 		// In this case, camera thread needs notify from the processing thread to 
 		// run as well as to put item in the data.
 		// Meaning that if processing thread does not call get() method, camera can not
@@ -63,14 +504,49 @@ public:
 		// In other words, this will do the perfect synchronization between two threads,
 		// first have to wait until to get notify from the second, and
 		// second as well have to wait until to get notify from the first.
-		if (sync_and_block_thread)
+		if (policy == fvkBufferPolicy::Block)
 		{
-			m_sema_put.wait();			// wait (block the thread) until you get notify from get() method.
+			if (!m_sema_put.try_wait())
+			{
+				const auto t = fvkBufferCounters::now();
+				if (!m_sema_put.wait())	// wait (block the thread) until you get notify from get() method.
+					return;				// buffer is closed.
+				m_stats.putWait(t);
+			}
 			m_mutex.lock();
-			m_data.push(item);			// protect the queue data and push item to queue.
+			m_data.emplace(std::forward<Args>(args)...);	// protect the queue data and push item to queue.
 			m_mutex.unlock();
+			m_stats.put();
 			m_sema_get.notify();		// notify get() method to pop data.
 		}
+		// In this case, camera thread will keep continue capturing and
+		// replaces the oldest item of a full queue with the new one.
+		// The number of items in the queue does not change, so no notify is needed.
+		else if (policy == fvkBufferPolicy::DropOldest)
+		{
+			while (!m_sema_put.try_wait())
+			{
+				if (m_sema_put.isClosed())
+					return;
+				{
+					std::lock_guard<std::mutex> lk(m_mutex);
+					if (!m_data.empty())
+					{
+						m_data.pop();
+						m_data.emplace(std::forward<Args>(args)...);
+						m_stats.put(true);
+						return;
+					}
+				}
+				// get() has taken the last item but not yet notified, it will in a moment.
+				std::this_thread::yield();
+			}
+			m_mutex.lock();
+			m_data.emplace(std::forward<Args>(args)...);
+			m_mutex.unlock();
+			m_stats.put();
+			m_sema_get.notify();
+		}
 		// In this case, camera thread will keep continue capturing,
 		// there is no notify needed from the processing thread, but
 		// in order to put item in the data, it needs notify from the processing thread.
@@ -80,35 +556,56 @@ public:
 			if (m_sema_put.try_wait())	// do not block thread, just wait to get notify from get() method to return true and run the following code.
 			{
 				m_mutex.lock();
-				m_data.push(item);		// protect the queue data and push item to queue.
+				m_data.emplace(std::forward<Args>(args)...);	// protect the queue data and push item to queue.
 				m_mutex.unlock();
+				m_stats.put();
 				m_sema_get.notify();	// notify get() method to pop data.
 			}
+			else
+			{
+				m_stats.dropNewest();
+			}
 		}
 	}
 
-	_T get()
-	{
-		m_sema_get.wait();				// wait until you get notify from put() method.
-		m_mutex.lock();
-		_T value = m_data.front();		// protect the queue data and pop item.
-		m_data.pop();
-		m_mutex.unlock();
-		m_sema_put.notify();			// notify put() method to add item in the queue.
-		return value;
-	}
-
-	auto empty() const
+	// discard all the items and recreate the slots.
+	void reset(const std::size_t capacity, const fvkBufferBackend backend)
 	{
 		std::lock_guard<std::mutex> lk(m_mutex);
-		return m_data.empty();
+		m_sema_put.reset(0);
+		m_sema_get.reset(0);
+		m_closed.store(false);
+		m_data = std::queue<_T>();
+		m_stats.reset();
+
+		m_capacity = capacity > 0 ? capacity : 1;
+		m_backend = backend;
+		if (backend == fvkBufferBackend::SpscRing)
+		{
+			m_ring = std::make_unique<fvkSpscRingBuffer<_T>>(m_capacity);
+		}
+		else
+		{
+			m_ring.reset();
+			for (std::size_t i = 0; i < m_capacity; i++)
+				m_sema_put.notify();
+		}
 	}
 
-private:
 	mutable std::mutex m_mutex;		// protect queue mutex
 	fvkSemaphore m_sema_put;
 	fvkSemaphore m_sema_get;
 	std::queue<_T> m_data;
+	std::size_t m_capacity;
+	std::atomic<fvkBufferPolicy> m_policy;
+	fvkBufferBackend m_backend;
+	std::unique_ptr<fvkSpscRingBuffer<_T>> m_ring;
+	fvkBufferCounters m_stats;
+	std::atomic<bool> m_closed;
+	std::unique_ptr<fvkStopCallback> m_stop_cb;
+	std::mutex m_readablemutex;		// protects the functions that wait for an item.
+	std::vector<std::function<void()>> m_readable;
+	std::atomic<std::size_t> m_nreadable;
 };
 
 }
@@ -0,0 +1,348 @@
+#pragma once
+#ifndef fvkSpscRingBuffer_h__
+#define fvkSpscRingBuffer_h__
+
+/*********************************************************************************
+created:	2026/10/18   10:12AM
+filename: 	fvkSpscRingBuffer.h
+file base:	fvkSpscRingBuffer
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	lock-free single-producer/single-consumer ring buffer with preallocated
+			slots and the same put/get contract as fvkSemaphoreBuffer.
+			The number of filled and free slots are kept in two atomic counters.
+			A counter only goes below zero when the ring is really empty (get) or
+			full (put), and only then the calling thread is parked on a semaphore.
+			In the common case, a frame handoff is just two atomic operations
+			without any mutex or condition variable.
+			Every slot carries a sequence number, so the producer can also discard
+			the oldest item itself (put_overwrite) while the consumer is reading.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkSemaphore.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace R3D
+{
+
+template <typename _T>
+class FVK_CAMERA_EXPORT fvkSpscRingBuffer
+{
+public:
+	// Description:
+	// Constructor that preallocates the given number of slots.
+	// Only one thread may call put() and only one thread may call get().
+	explicit fvkSpscRingBuffer(const std::size_t capacity = 1) :
+		m_capacity(capacity > 0 ? capacity : 1),
+		m_slots(new Slot[m_capacity]),
+		m_head(0),
+		m_tail(0),
+		m_items(0),
+		m_free(static_cast<int>(m_capacity))
+	{
+		for (std::size_t i = 0; i < m_capacity; i++)
+			m_slots[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	// Description:
+	// Non-implemented.
+	fvkSpscRingBuffer(const fvkSpscRingBuffer&) = delete;
+	fvkSpscRingBuffer& operator=(const fvkSpscRingBuffer&) = delete;
+
+	// Description:
+	// Function to add an item to the ring (producer thread only).
+	// If sync_and_block_thread is true, the thread is parked while the ring is full,
+	// otherwise the item is discarded when there is no free slot.
+	void put(const _T& item, const bool sync_and_block_thread = false)
+	{
+		emplace(sync_and_block_thread, item);
+	}
+	// Description:
+	// Function to move an item into the ring (producer thread only).
+	void put(_T&& item, const bool sync_and_block_thread = false)
+	{
+		emplace(sync_and_block_thread, std::move(item));
+	}
+	// Description:
+	// Function to construct an item in a free slot of the ring (producer thread only).
+	// The item is only constructed if it is not discarded. It returns false if it is discarded.
+	template <typename... Args>
+	auto emplace(const bool sync_and_block_thread, Args&&... args) -> bool
+	{
+		if (sync_and_block_thread)
+		{
+			if (!acquire(m_free, m_sema_free))	// park while the ring is full.
+				return false;					// ring is closed.
+		}
+		else if (!try_acquire(m_free))
+		{
+			return false;					// ring is full, drop the item.
+		}
+
+		push(std::forward<Args>(args)...);
+		return true;
+	}
+
+	// Description:
+	// Function to add an item to the ring (producer thread only).
+	// If the ring is full, the oldest item is discarded to make room for the new one,
+	// so the ring always holds the most recent items.
+	void put_overwrite(const _T& item)
+	{
+		emplace_overwrite(item);
+	}
+	// Description:
+	// Function to move an item into the ring (producer thread only).
+	// If the ring is full, the oldest item is discarded.
+	void put_overwrite(_T&& item)
+	{
+		emplace_overwrite(std::move(item));
+	}
+	// Description:
+	// Function to construct an item in the ring (producer thread only).
+	// If the ring is full, the oldest item is discarded. It returns true if an item is discarded.
+	template <typename... Args>
+	auto emplace_overwrite(Args&&... args) -> bool
+	{
+		auto discarded = false;
+		if (!try_acquire(m_free))
+		{
+			// ring is full, take the oldest item out. If the consumer has already
+			// claimed all the items, one of its slots will be freed in a moment.
+			if (try_acquire(m_items))
+			{
+				pop();
+				discarded = true;
+			}
+			if (!acquire(m_free, m_sema_free))
+				return discarded;			// ring is closed.
+		}
+
+		push(std::forward<Args>(args)...);
+		return discarded;
+	}
+
+	// Description:
+	// Function to discard the oldest item of the ring without adding one (producer thread only).
+	// It returns false if the ring is empty.
+	auto discard_oldest() -> bool
+	{
+		if (!try_acquire(m_items))
+			return false;
+		pop();
+		return true;
+	}
+
+	// Description:
+	// Function to remove an item from the ring (consumer thread only).
+	// It parks the thread while the ring is empty.
+	// The item is moved out of its slot. If the ring is closed, it returns an empty item.
+	_T get()
+	{
+		if (!acquire(m_items, m_sema_items))	// park while the ring is empty.
+			return _T();
+		return pop();
+	}
+	// Description:
+	// Function to remove an item from the ring (consumer thread only).
+	// It parks the thread for at most the given milliseconds while the ring is empty,
+	// and returns false if no item arrived in that time (item is not changed).
+	auto try_get(_T& item, const unsigned long milliseconds = 0) -> bool
+	{
+		if (!try_acquire_for(m_items, m_sema_items, milliseconds))
+			return false;
+		item = pop();
+		return true;
+	}
+
+	// Description:
+	// Function to remove up to max items from the ring at once (consumer thread only)
+	// and append them to items. It parks the thread for at most the given milliseconds
+	// until max items (or as many as the ring can hold) are available.
+	// It returns the number of items appended, that can be less than max on timeout.
+	auto get_batch(std::vector<_T>& items, const std::size_t max, const unsigned long milliseconds = 0) -> std::size_t
+	{
+		const auto target = max < m_capacity ? max : m_capacity;
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+
+		std::size_t n = 0;
+		while (n < target)
+		{
+			// take every item that is already in the ring, the slots are freed right away.
+			auto k = try_acquire_many(m_items, static_cast<int>(target - n));
+			for (; k > 0; k--, n++)
+				items.push_back(pop());
+			if (n >= target)
+				break;
+
+			const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+			if (left <= 0 || !try_acquire_for(m_items, m_sema_items, static_cast<unsigned long>(left)))
+				break;
+			items.push_back(pop());
+			n++;
+		}
+		return n;
+	}
+
+	// Description:
+	// Function that closes the ring, the parked producer and consumer are woken up and
+	// every following wait returns immediately. The ring can not be used anymore after
+	// that, it has to be recreated.
+	void close()
+	{
+		m_sema_items.close();
+		m_sema_free.close();
+	}
+
+	// Description:
+	// Function that returns true if there is no item in the ring.
+	auto empty() const
+	{
+		return m_items.load(std::memory_order_acquire) <= 0;
+	}
+	// Description:
+	// Function that returns true if there is no free slot in the ring.
+	auto full() const
+	{
+		return m_free.load(std::memory_order_acquire) <= 0;
+	}
+	// Description:
+	// Function that returns the total number of preallocated slots.
+	auto capacity() const
+	{
+		return m_capacity;
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<std::size_t> seq;	// position the slot is ready for (pos: free to write, pos + 1: filled).
+		_T item;
+	};
+
+	// take one count, park on the semaphore if there is none.
+	// It returns false if the semaphore is closed.
+	static auto acquire(std::atomic<int>& count, fvkSemaphore& sema) -> bool
+	{
+		if (count.fetch_sub(1, std::memory_order_acquire) <= 0)
+			return sema.wait();
+		return !sema.isClosed();
+	}
+	// take one count if there is one, never park.
+	static auto try_acquire(std::atomic<int>& count) -> bool
+	{
+		auto n = count.load(std::memory_order_relaxed);
+		do
+		{
+			if (n <= 0)
+				return false;
+		} while (!count.compare_exchange_weak(n, n - 1, std::memory_order_acquire, std::memory_order_relaxed));
+		return true;
+	}
+	// take up to max counts, never park.
+	static auto try_acquire_many(std::atomic<int>& count, const int max) -> int
+	{
+		auto n = count.load(std::memory_order_relaxed);
+		int k;
+		do
+		{
+			if (n <= 0)
+				return 0;
+			k = n < max ? n : max;
+		} while (!count.compare_exchange_weak(n, n - k, std::memory_order_acquire, std::memory_order_relaxed));
+		return k;
+	}
+	// take one count, park on the semaphore for at most the given milliseconds if there is none.
+	static auto try_acquire_for(std::atomic<int>& count, fvkSemaphore& sema, const unsigned long milliseconds) -> bool
+	{
+		if (sema.isClosed())
+			return false;
+		if (try_acquire(count))
+			return true;
+		if (milliseconds == 0)
+			return false;
+
+		if (count.fetch_sub(1, std::memory_order_acquire) > 0)
+			return true;
+		if (sema.wait_for(milliseconds))
+			return true;
+		if (sema.isClosed())
+			return false;				// the counts do not matter anymore.
+
+		// timed out, give the count back. If it is not negative anymore, release()
+		// has already counted on this thread being parked, so take its notify instead.
+		auto n = count.load(std::memory_order_relaxed);
+		while (n < 0)
+		{
+			if (count.compare_exchange_weak(n, n + 1, std::memory_order_relaxed, std::memory_order_relaxed))
+				return false;
+		}
+		sema.wait();
+		return true;
+	}
+	// give one count back, wake the parked thread if there is one.
+	static void release(std::atomic<int>& count, fvkSemaphore& sema)
+	{
+		if (count.fetch_add(1, std::memory_order_release) < 0)
+			sema.notify();
+	}
+
+	template <typename... Args>
+	void push(Args&&... args)
+	{
+		auto& s = m_slots[m_tail % m_capacity];
+		while (s.seq.load(std::memory_order_acquire) != m_tail)
+			std::this_thread::yield();		// the previous item of this slot is still being read.
+
+		s.item = _T(std::forward<Args>(args)...);
+		s.seq.store(m_tail + 1, std::memory_order_release);
+		m_tail++;
+
+		release(m_items, m_sema_items);
+	}
+	_T pop()
+	{
+		// the consumer and the overwriting producer can both pop, so the read position is atomic.
+		const auto pos = m_head.fetch_add(1, std::memory_order_relaxed);
+		auto& s = m_slots[pos % m_capacity];
+		while (s.seq.load(std::memory_order_acquire) != pos + 1)
+			std::this_thread::yield();
+
+		_T value = std::move(s.item);
+		s.item = _T();					// do not keep a reference to the item in the slot.
+		s.seq.store(pos + m_capacity, std::memory_order_release);
+
+		release(m_free, m_sema_free);
+		return value;
+	}
+
+	const std::size_t m_capacity;
+	std::unique_ptr<Slot[]> m_slots;
+	alignas(64) std::atomic<std::size_t> m_head;	// read position.
+	alignas(64) std::size_t m_tail;					// write position, only touched by the producer thread.
+	alignas(64) std::atomic<int> m_items;			// number of filled slots, negative when the consumer is parked.
+	alignas(64) std::atomic<int> m_free;			// number of free slots, negative when the producer is parked.
+	fvkSemaphore m_sema_items;
+	fvkSemaphore m_sema_free;
+};
+
+}
+
+#endif // fvkSpscRingBuffer_h__
@@ -0,0 +1,189 @@
+#pragma once
+#ifndef fvkStopToken_h__
+#define fvkStopToken_h__
+
+/*********************************************************************************
+created:	2026/10/18   03:35PM
+filename: 	fvkStopToken.h
+file base:	fvkStopToken
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	cooperative stop requests, like std::stop_source, std::stop_token and
+std::stop_callback of C++20.
+A fvkStopSource is owned by whoever starts the threads, every thread gets a
+fvkStopToken from it. A fvkStopCallback calls a function when the stop is requested,
+it is used to wake up a thread that waits (for example, to close a buffer).
+
+usage example:
+--------------
+
+fvkStopSource source;
+fvkStopCallback cb(source.get_token(), [&]() { buffer.close(); });
+std::thread th([token = source.get_token()]() { while (!token.stop_requested()) { ... } });
+source.request_stop();	// calls buffer.close() and ends the loop.
+th.join();
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace R3D
+{
+
+class fvkStopCallback;
+
+// shared state of a stop source and all of its tokens.
+class FVK_CAMERA_EXPORT fvkStopState
+{
+public:
+	fvkStopState() : m_stop(false) {}
+
+private:
+	friend class fvkStopSource;
+	friend class fvkStopToken;
+	friend class fvkStopCallback;
+
+	std::atomic<bool> m_stop;
+	std::mutex m_mutex;
+	std::vector<fvkStopCallback*> m_callbacks;
+};
+
+class FVK_CAMERA_EXPORT fvkStopToken
+{
+public:
+	// Description:
+	// Default constructor that creates a token that can never be stopped.
+	fvkStopToken() = default;
+
+	// Description:
+	// Function that returns true if the stop has been requested.
+	auto stop_requested() const -> bool
+	{
+		return m_state && m_state->m_stop.load(std::memory_order_acquire);
+	}
+	// Description:
+	// Function that returns true if this token belongs to a stop source.
+	auto stop_possible() const -> bool
+	{
+		return static_cast<bool>(m_state);
+	}
+
+private:
+	friend class fvkStopSource;
+	friend class fvkStopCallback;
+	explicit fvkStopToken(std::shared_ptr<fvkStopState> state) : m_state(std::move(state)) {}
+
+	std::shared_ptr<fvkStopState> m_state;
+};
+
+class FVK_CAMERA_EXPORT fvkStopSource
+{
+public:
+	// Description:
+	// Default constructor that creates a new stop state.
+	fvkStopSource() : m_state(std::make_shared<fvkStopState>()) {}
+
+	// Description:
+	// Function that returns a token of this source.
+	auto get_token() const -> fvkStopToken
+	{
+		return fvkStopToken(m_state);
+	}
+
+	// Description:
+	// Function that requests the stop and calls all the registered callbacks.
+	// It returns false if the stop has been requested already.
+	auto request_stop() -> bool;
+
+	// Description:
+	// Function that returns true if the stop has been requested.
+	auto stop_requested() const -> bool
+	{
+		return m_state->m_stop.load(std::memory_order_acquire);
+	}
+
+private:
+	std::shared_ptr<fvkStopState> m_state;
+};
+
+class FVK_CAMERA_EXPORT fvkStopCallback
+{
+public:
+	// Description:
+	// Constructor that registers f to be called when the stop of token is requested.
+	// If the stop has been requested already, f is called right away.
+	// f must not create or destroy a callback of the same source.
+	fvkStopCallback(const fvkStopToken& token, std::function<void()> f) :
+		m_state(token.m_state),
+		m_func(std::move(f))
+	{
+		if (!m_state)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lk(m_state->m_mutex);
+			if (!m_state->m_stop.load())
+			{
+				m_state->m_callbacks.push_back(this);
+				return;
+			}
+		}
+		m_func();
+	}
+	// Description:
+	// Destructor that unregisters the callback. If the callback is being called by
+	// request_stop() on another thread, it waits until the call has finished.
+	~fvkStopCallback()
+	{
+		if (!m_state)
+			return;
+		std::lock_guard<std::mutex> lk(m_state->m_mutex);
+		auto& v = m_state->m_callbacks;
+		v.erase(std::remove(v.begin(), v.end(), this), v.end());
+	}
+
+	// Description:
+	// Non-implemented.
+	fvkStopCallback(const fvkStopCallback&) = delete;
+	fvkStopCallback& operator=(const fvkStopCallback&) = delete;
+
+private:
+	friend class fvkStopSource;
+
+	std::shared_ptr<fvkStopState> m_state;
+	std::function<void()> m_func;
+};
+
+inline auto fvkStopSource::request_stop() -> bool
+{
+	if (m_state->m_stop.exchange(true))
+		return false;
+
+	// the callbacks are called under the lock, so a callback can not be destroyed while it is called.
+	std::lock_guard<std::mutex> lk(m_state->m_mutex);
+	for (auto cb : m_state->m_callbacks)
+		cb->m_func();
+	m_state->m_callbacks.clear();
+	return true;
+}
+
+}
+
+#endif // fvkStopToken_h__
@@ -59,22 +59,54 @@ std::thread th(std::ref(task), any_function);
 
 #include "fvkCameraExport.h"
 #include "fvkAverageFps.h"
+#include "fvkStopToken.h"
 
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace R3D
 {
 
+// Description:
+// How the thread keeps its rate (see fvkThread::setPacing()).
+// Relative sleeps for the delay after every iteration, so the rate drops by the time run() takes.
+// CatchUp starts every iteration at a fixed deadline (start + n * delay). If an iteration is late,
+// the next one starts right away to make up for it, but the loop never runs more than one delay behind.
+// Skip starts every iteration at a fixed deadline too, but a late iteration skips the missed deadlines,
+// so the iterations always stay on the same time grid.
+enum class fvkPacing
+{
+	Relative,
+	CatchUp,
+	Skip
+};
+
+// Description:
+// Scheduling policy of a thread (see fvkThread::setScheduling()).
+// Other is the normal time-sharing policy, its priority is the nice value (-20 to 19, lower is more important).
+// Fifo and RoundRobin are the real-time policies, their priority is 1 to 99 (higher is more important),
+// a Fifo thread runs until it blocks or yields. On Linux, the real-time policies and a negative nice value
+// require the CAP_SYS_NICE capability (or root). On Windows, the priority is mapped to a thread priority.
+enum class fvkSchedPolicy
+{
+	Other,
+	Fifo,
+	RoundRobin
+};
+
 class FVK_CAMERA_EXPORT fvkThread
 {
 
 public:
 	// Description:
 	// Default constructor to create and initializes the data.
-	// Default thread delay is 30 milliseconds.
+	// Default thread delay is 33.3 milliseconds (30 fps).
 	fvkThread();
 	// Description:
 	// Default destructor.
@@ -98,6 +130,27 @@ public:
 	// This function will be called by the thread function (functor).
 	void start(std::function<void()> func = nullptr);
 	// Description:
+	// Function to start this thread, it stops when the stop of the given token is requested,
+	// the same as calling stop(). A stop that has been requested before this call is not lost,
+	// the thread leaves start() right away.
+	void start(const fvkStopToken& token, std::function<void()> func = nullptr);
+	// Description:
+	// Functions to execute this thread one iteration at a time, for an executor that runs
+	// many threads on a few OS threads (see fvkExecutor). begin() prepares a new run like
+	// start() does, then step() executes one iteration and returns false once the thread
+	// has been stopped (after that the run is over, like leaving start()).
+	// The next step() is due at getDeadline(), step() never sleeps.
+	void begin(const fvkStopToken& token = fvkStopToken());
+	auto step(std::function<void()> func = nullptr) -> bool;
+	// Description:
+	// Function that returns the time point at which the next iteration is due.
+	auto getDeadline() const -> std::chrono::steady_clock::time_point { return m_deadline; }
+	// Description:
+	// Virtual function that returns false if an iteration would block right now
+	// (for example, waiting for a frame). An executor does not execute step() then, and
+	// looks at this thread again when it is woken up. The thread of start() never calls it.
+	virtual auto ready() -> bool { return true; }
+	// Description:
 	// Function to pause (true) or resume (false) this thread.
 	void pause(const bool b);
 	// Description:
@@ -106,30 +159,107 @@ public:
 
 	// Description:
 	// Function to stop this thread.
+	// The thread leaves start() after the current iteration, a paused thread leaves it right away.
 	void stop();
 	// Description:
 	// Function that returns true if the thread is active or in running mode.
 	auto active() const -> bool;
+	// Description:
+	// Function that returns true while the thread is executing start().
+	auto isRunning() const -> bool;
+	// Description:
+	// Function that blocks the calling thread until this thread has entered start(),
+	// or until the given milliseconds are elapsed. It returns true if the thread is running.
+	auto waitForStarted(const unsigned long milliseconds) -> bool;
+	// Description:
+	// Function that blocks the calling thread until this thread has left start(),
+	// or until the given milliseconds are elapsed. It returns true if the thread is not running.
+	auto waitForFinished(const unsigned long milliseconds) -> bool;
+
+	// Description:
+	// Function that returns the time of the last sign of life of this thread: the end of its
+	// last iteration (or the start of the run, or the last look at the pause state).
+	// A watchdog compares it with the current time to find a stalled thread (see fvkWatchdog).
+	auto getHeartbeat() const -> std::chrono::steady_clock::time_point;
+	// Description:
+	// Function that returns the delay until the next iteration that has been taken after the last
+	// heartbeat (see getIterationDelay()), so the next heartbeat is not expected before that.
+	auto getHeartbeatPeriod() const -> std::chrono::nanoseconds;
 
 	// Description:
 	// Function to set the time delay in milliseconds which makes 
 	// delay this thread for the specified time.
-	// Default delay is 30 milliseconds.
+	// Default delay is 33.3 milliseconds (30 fps).
 	void setDelay(const int delay_msec);
 	// Description:
 	// Function to get the time delay in milliseconds.
 	auto getDelay() -> int;
+	// Description:
+	// Function to set the delay as a rate in iterations (frames) per second, with a resolution
+	// below one millisecond, for example setFrameRate(30) gives a delay of 33.333 milliseconds.
+	// A rate of 0 (or less) means no delay.
+	void setFrameRate(const double fps);
+	// Description:
+	// Function to get the rate in iterations (frames) per second, 0 if there is no delay.
+	auto getFrameRate() const -> double;
+
+	// Description:
+	// Function to set how this thread keeps its rate.
+	// Default is fvkPacing::CatchUp, so the rate given by the delay is met even if run() takes time.
+	void setPacing(const fvkPacing pacing) { m_pacing = pacing; }
+	// Description:
+	// Function to get how this thread keeps its rate.
+	auto getPacing() const -> fvkPacing { return m_pacing; }
+	// Description:
+	// Function that returns the number of iterations that have missed their deadline since start().
+	auto getOverruns() const -> int { return m_overruns; }
+
+	// Description:
+	// Function to pin this thread to the given CPU cores (0 is the first core), an empty
+	// list allows all the cores. The attributes of this thread (affinity, scheduling and name)
+	// are applied by the thread itself, when it enters start() and at its next iteration
+	// when they are changed while it is running. A thread that is stepped by an executor
+	// does not own its OS thread, so the attributes are not applied then.
+	void setAffinity(const std::vector<int>& cpus);
+	// Description:
+	// Function to get the CPU cores this thread is pinned to, empty if all the cores are allowed.
+	auto getAffinity() const -> std::vector<int>;
+	// Description:
+	// Function to set the scheduling policy and priority of this thread (see fvkSchedPolicy).
+	// Default is fvkSchedPolicy::Other with the nice value 0.
+	void setScheduling(const fvkSchedPolicy policy, const int priority);
+	// Description:
+	// Function to get the scheduling policy of this thread.
+	auto getSchedPolicy() const -> fvkSchedPolicy;
+	// Description:
+	// Function to get the scheduling priority (or nice value) of this thread.
+	auto getSchedPriority() const -> int;
+	// Description:
+	// Function to set the name of this thread, it is shown by the debuggers and by top/htop.
+	// On Linux, only the first 15 characters are used.
+	void setName(const std::string& name);
+	// Description:
+	// Function to get the name of this thread.
+	auto getName() const -> std::string;
 
 	// Description:
 	// Function that returns the average frames per second of this thread.
-	auto getAvgFps() -> int;
+	// It never blocks, it can be called by a GUI thread at any rate.
+	auto getAvgFps() const -> int;
 
 	// Description:
 	// Function that sets the total number of processed or passed frames.
+	// When it is called by another thread, the number is applied by this thread
+	// at its next iteration.
 	void setFrameNumber(const int frame);
 	// Description:
 	// Function that returns the total number of processed or passed frames.
-	auto getFrameNumber() -> int;
+	// It never blocks, it can be called by a GUI thread at any rate.
+	auto getFrameNumber() const -> int;
+	// Description:
+	// Function that returns a consistent copy of the statistics of this thread
+	// (average FPS and number of frames of the same iteration). It never blocks.
+	auto getStats() const -> fvkThreadStats;
 
 	// Description:
 	// Function that sleeps a thread for specified time (a thread in which this function is called).
@@ -137,17 +267,70 @@ public:
 	// Description:
 	// Function that sleeps a thread till specified time point (a thread in which this function is called).
 	static void sleep_until(const unsigned long milliseconds);
+	// Description:
+	// Function that sleeps a thread till the given time point of the steady clock.
+	static void sleep_until(const std::chrono::steady_clock::time_point& time);
 
 protected:
+	// Description:
+	// Virtual functions that are called when a run of this thread begins (by start() or begin())
+	// and when it ends (by the thread, right before it leaves start()).
+	// They can be overridden to set up and tear down the helpers of a derived thread.
+	virtual void onStart() {}
+	virtual void onStop() {}
+	// Description:
+	// Virtual function that returns the delay until the next iteration in nanoseconds.
+	// It is the delay that is set by setDelay() or setFrameRate(), it can be overridden
+	// to slow a thread down for a while without changing its frame rate.
+	virtual auto getIterationDelay() -> long long { return m_delay.load(); }
+
 	fvkAverageFps m_avgfps;
 
 private:
-	std::mutex m_statsmutex;
+	void setRunning(const bool b);
+	// record a sign of life at the given time.
+	void beat(const std::chrono::steady_clock::time_point& time);
+	// move the deadline to the next iteration according to the pacing.
+	void advance(std::chrono::steady_clock::time_point& deadline);
+	// copy the statistics of this thread for the readers of the other threads.
+	void publishStats();
+	// apply the affinity, scheduling and name that have been set to the calling thread.
+	void applyAttributes();
+
+	enum : int
+	{
+		AttrAffinity = 0x1,
+		AttrScheduling = 0x2,
+		AttrName = 0x4
+	};
+
+	// the statistics are published with a sequence lock, the thread is the only writer,
+	// a reader retries if the thread has published in the meantime.
+	std::atomic<unsigned> m_statsseq;
+	std::atomic<int> m_nfps;
+	std::atomic<int> m_nframes;
+	std::atomic<int> m_pending_frame;	// frame number set by another thread, INT_MIN if none.
 	std::mutex m_pausemutex;
 	std::condition_variable m_pausecond;
 	std::atomic<bool> m_isstop;
+	mutable std::mutex m_runningmutex;
+	std::condition_variable m_runningcond;
+	bool m_isrunning;
 	bool m_ispause;
-	int m_delay;
+	std::atomic<long long> m_delay;		// delay between the iterations in nanoseconds.
+	std::atomic<fvkPacing> m_pacing;
+	std::atomic<int> m_overruns;
+	std::atomic<std::chrono::steady_clock::rep> m_heartbeat;	// time of the last sign of life.
+	std::atomic<long long> m_period;	// delay after the last sign of life in nanoseconds.
+	std::chrono::steady_clock::time_point m_deadline;	// deadline of the next iteration.
+	std::unique_ptr<fvkStopCallback> m_stopcb;			// stops this thread on the stop request of a token.
+	mutable std::mutex m_attrmutex;		// protects the attributes of the OS thread.
+	std::vector<int> m_affinity;
+	fvkSchedPolicy m_schedpolicy;
+	int m_schedpriority;
+	std::string m_name;
+	int m_attrset;						// attributes that have been set, the others are left as they are.
+	std::atomic<bool> m_attrchanged;	// the attributes have to be applied at the next iteration.
 };
 
 }
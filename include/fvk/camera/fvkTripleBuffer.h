@@ -0,0 +1,121 @@
+#pragma once
+#ifndef fvkTripleBuffer_h__
+#define fvkTripleBuffer_h__
+
+/*********************************************************************************
+created:	2026/10/18   12:20PM
+filename: 	fvkTripleBuffer.h
+file base:	fvkTripleBuffer
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	wait-free "latest item" mailbox based on triple buffering.
+The writer always has a slot to write into and the reader always has a slot to
+read from, the third slot is swapped between them with a single atomic exchange.
+Neither thread ever blocks or waits for the other, the writer is never slowed down
+by the reader, and the reader always gets the most recently published item.
+Only one thread may publish and only one thread may read.
+
+usage example:
+--------------
+
+fvkTripleBuffer<cv::Mat> mailbox;
+mailbox.publish(frame);			// processing thread, at its own rate.
+cv::Mat m;
+if (mailbox.read(m))			// GUI thread, at its own refresh rate.
+	cv::imshow("FVK Camera", m);
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <atomic>
+
+namespace R3D
+{
+
+template <typename _T>
+class FVK_CAMERA_EXPORT fvkTripleBuffer
+{
+public:
+	// Description:
+	// Default constructor that creates an empty mailbox.
+	fvkTripleBuffer() :
+		m_back(0),
+		m_middle(1),
+		m_front(2)
+	{
+	}
+
+	// Description:
+	// Non-implemented.
+	fvkTripleBuffer(const fvkTripleBuffer&) = delete;
+	fvkTripleBuffer& operator=(const fvkTripleBuffer&) = delete;
+
+	// Description:
+	// Function to publish a new item (writer thread only).
+	// It replaces the item that has not been read yet.
+	void publish(const _T& item)
+	{
+		m_slots[m_back] = item;
+		swapBack();
+	}
+	// Description:
+	// Function to publish a new item (writer thread only).
+	void publish(_T&& item)
+	{
+		m_slots[m_back] = std::move(item);
+		swapBack();
+	}
+
+	// Description:
+	// Function to get the most recently published item (reader thread only).
+	// It returns true if a new item has been published since the last read,
+	// otherwise item is the same as in the last read.
+	auto read(_T& item) -> bool
+	{
+		const auto fresh = (m_middle.load(std::memory_order_relaxed) & FRESH) != 0;
+		if (fresh)
+			m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+
+		item = m_slots[m_front];
+		return fresh;
+	}
+
+	// Description:
+	// Function that returns true if a new item has been published since the last read.
+	auto hasNew() const -> bool
+	{
+		return (m_middle.load(std::memory_order_relaxed) & FRESH) != 0;
+	}
+
+private:
+	enum : unsigned char
+	{
+		INDEX = 0x3,	// slot index of the middle slot.
+		FRESH = 0x4		// set when the middle slot holds an item that has not been read.
+	};
+
+	void swapBack()
+	{
+		m_back = m_middle.exchange(static_cast<unsigned char>(m_back | FRESH), std::memory_order_acq_rel) & INDEX;
+	}
+
+	_T m_slots[3];
+	alignas(64) unsigned char m_back;				// only touched by the writer thread.
+	alignas(64) std::atomic<unsigned char> m_middle;
+	alignas(64) unsigned char m_front;				// only touched by the reader thread.
+};
+
+}
+
+#endif // fvkTripleBuffer_h__
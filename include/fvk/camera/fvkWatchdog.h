@@ -0,0 +1,126 @@
+#pragma once
+#ifndef fvkWatchdog_h__
+#define fvkWatchdog_h__
+
+/*********************************************************************************
+created:	2026/10/18   07:50PM
+filename: 	fvkWatchdog.h
+file base:	fvkWatchdog
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	watchdog that finds the stalled camera and processing threads, for example
+a camera thread that hangs in grab() when a USB camera stops responding.
+Every fvkThread writes a heartbeat after each iteration (fvkThread::getHeartbeat()),
+the watchdog looks at the heartbeats of the watched threads periodically on a
+fvkScheduler, so watching any number of threads costs no extra thread per camera.
+A thread is stalled when it could make progress (fvkThread::ready(), it does not wait
+for a frame or for room in a blocking buffer), it is not paused, and its heartbeat has
+not changed for longer than its timeout (or than two of its iterations, if the thread
+runs at a lower frame rate or is throttled, see fvkThread::getHeartbeatPeriod()).
+The stall is reported once through a callback, and once more when the thread makes
+progress again.
+
+usage example:
+--------------
+
+fvkWatchdog watchdog;
+watchdog.watch(cam.getCamThread(), std::chrono::seconds(2), [](fvkThread* t, bool stalled)
+{
+	if (stalled) static_cast<fvkCameraThread*>(t)->requestReopen();	// once grab() has returned.
+});
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkScheduler.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace R3D
+{
+
+class fvkThread;
+
+// Description:
+// Function that is called by a watchdog when a thread has stalled (stalled is true), and when
+// it makes progress again (stalled is false). It is called on the scheduler thread, so it
+// should not block, it should only hand the work over (for example, request a reopen).
+using fvkStallFunc = std::function<void(fvkThread* thread, const bool stalled)>;
+
+class FVK_CAMERA_EXPORT fvkWatchdog
+{
+public:
+	// Description:
+	// Constructor that looks at the watched threads on its own scheduler thread every period.
+	explicit fvkWatchdog(const std::chrono::milliseconds& period = std::chrono::milliseconds(100));
+	// Description:
+	// Constructor that looks at the watched threads on the given scheduler every period,
+	// so the watchdog shares its thread with the other auxiliary jobs.
+	// The scheduler must outlive the watchdog.
+	explicit fvkWatchdog(fvkScheduler& scheduler, const std::chrono::milliseconds& period = std::chrono::milliseconds(100));
+	// Description:
+	// Destructor that stops watching, it waits until a check that is being executed has finished.
+	~fvkWatchdog();
+
+	// Description:
+	// Non-implemented.
+	fvkWatchdog(const fvkWatchdog&) = delete;
+	fvkWatchdog& operator=(const fvkWatchdog&) = delete;
+
+	// Description:
+	// Function to watch a thread, f is called when it has made no progress for longer than the
+	// given timeout (at least two iterations of the thread) while it could. A thread that is watched already gets the new timeout and function.
+	// The thread must be unwatched before it is destroyed.
+	void watch(fvkThread* thread, const std::chrono::milliseconds& timeout, fvkStallFunc f);
+	// Description:
+	// Function to stop watching a thread. It returns false if the thread is not watched.
+	// f of the thread is not called anymore after this call (unless it is called by f itself).
+	auto unwatch(fvkThread* thread) -> bool;
+	// Description:
+	// Function that returns true if the given thread is stalled right now.
+	auto isStalled(fvkThread* thread) const -> bool;
+	// Description:
+	// Function that returns the number of stalls that have been reported since the thread is watched.
+	auto getStallCount(fvkThread* thread) const -> int;
+
+private:
+	struct Watch
+	{
+		fvkThread* thread;
+		std::chrono::steady_clock::duration timeout;
+		fvkStallFunc func;
+		std::chrono::steady_clock::time_point beat;		// last heartbeat that has been seen.
+		std::chrono::steady_clock::time_point since;	// last time the thread made progress or had to wait.
+		bool stalled;
+		int nstalls;
+	};
+
+	// look at all the watched threads.
+	void check();
+	auto find(fvkThread* thread) const -> std::vector<Watch>::const_iterator;
+	auto find(fvkThread* thread) -> std::vector<Watch>::iterator;
+
+	std::unique_ptr<fvkScheduler> m_own;	// scheduler of this watchdog, if it has not been given one.
+	fvkScheduler& m_scheduler;
+	mutable std::mutex m_mutex;				// protects the watched threads.
+	std::recursive_mutex m_checkmutex;		// held while the functions of a check are called, f can call unwatch().
+	std::vector<Watch> m_watches;
+	std::size_t m_task;
+};
+
+}
+
+#endif // fvkWatchdog_h__
@@ -28,66 +28,65 @@ purpose:	Thread-safe multi-threaded camera class for any type of camera device.
 using namespace R3D;
 
 fvkCamera::fvkCamera(const int device_index, const cv::Size& frame_size, const int api) :
-	p_stdct(nullptr),
-	p_stdpt(nullptr),
-	m_ct_handle(nullptr),
-	m_pt_handle(nullptr)
+	m_ct_handle(),
+	m_pt_handle(),
+	m_stop_latency(0),
+	p_watchdog(nullptr)
 {
-	const auto b = new fvkSemaphoreBuffer<cv::Mat>();
+	const auto b = new fvkSemaphoreBuffer<fvkFrame>();
 	p_ct = new fvkCameraThreadOpenCV(device_index, frame_size, api, b);
 	p_pt = new fvkProcessingThread(device_index, this, b);
+	reserveFrames();
 }
 fvkCamera::fvkCamera(const std::string& video_file, const cv::Size& frame_size, const int api) :
-	p_stdct(nullptr),
-	p_stdpt(nullptr),
-	m_ct_handle(nullptr),
-	m_pt_handle(nullptr)
+	m_ct_handle(),
+	m_pt_handle(),
+	m_stop_latency(0),
+	p_watchdog(nullptr)
 {
-	const auto b = new fvkSemaphoreBuffer<cv::Mat>();
+	const auto b = new fvkSemaphoreBuffer<fvkFrame>();
 	p_ct = new fvkCameraThreadOpenCV(video_file, frame_size, api, b);
 	p_pt = new fvkProcessingThread(p_ct->getDeviceIndex(), this, b);
+	reserveFrames();
 }
 
 fvkCamera::fvkCamera(fvkCameraThread* ct) :
-	p_stdct(nullptr),
-	p_stdpt(nullptr),
-	m_ct_handle(nullptr),
-	m_pt_handle(nullptr)
+	m_ct_handle(),
+	m_pt_handle(),
+	m_stop_latency(0),
+	p_watchdog(nullptr)
 {
-	const auto b = new fvkSemaphoreBuffer<cv::Mat>();
+	const auto b = new fvkSemaphoreBuffer<fvkFrame>();
 	p_ct = ct;
 	p_ct->setSemaphoreBuffer(b);
 	p_pt = new fvkProcessingThread(ct->getDeviceIndex(), this, b);
+	reserveFrames();
 }
 
 fvkCamera::fvkCamera(fvkCameraThread* ct, fvkProcessingThread* pt) :
-	p_stdct(nullptr),
-	p_stdpt(nullptr),
-	m_ct_handle(nullptr),
-	m_pt_handle(nullptr),
 	p_ct(ct),
-	p_pt(pt)
+	p_pt(pt),
+	m_ct_handle(),
+	m_pt_handle(),
+	m_stop_latency(0),
+	p_watchdog(nullptr)
 {
 	if(ct->getSemaphoreBuffer() == nullptr && pt->getSemaphoreBuffer() == nullptr)
 	{
-		const auto b = new fvkSemaphoreBuffer<cv::Mat>();
+		const auto b = new fvkSemaphoreBuffer<fvkFrame>();
 		p_ct->setSemaphoreBuffer(b);
 		p_pt->setSemaphoreBuffer(b);
 	}
+	reserveFrames();
 }
 
 fvkCamera::~fvkCamera()
 {
+	unwatch();
 	disconnect();
 
-
-	if(p_stdct)
-		delete p_stdct;
-	p_stdct = nullptr;
-
-	if (p_stdpt)
-		delete p_stdpt;
-	p_stdpt = nullptr;
+	// the threads use p_ct and p_pt, they must have left before these are deleted.
+	joinThreads();
 
 	if (p_pt)
 		delete p_pt;
@@ -107,6 +106,8 @@ fvkCamera::~fvkCamera()
 
 auto fvkCamera::disconnect() -> bool
 {
+	const auto stop_start = std::chrono::steady_clock::now();
+
 	if (p_ct)
 	{
 		if (!p_ct->isOpened())
@@ -115,11 +116,13 @@ auto fvkCamera::disconnect() -> bool
 			return false;
 		}
 
-		// stop the main thread.
-		if (p_ct->active())
-			p_ct->stop();
+		// stop both threads, the stop request also closes the buffer, so the threads
+		// that are waiting for a free slot or a frame are woken up.
+		m_stop.request_stop();
+		p_ct->subscribers().close();
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		// the device can only be closed when the camera thread does not grab from it anymore.
+		joinCamThread();
 
 		// release / close the device.
 		if (p_ct->close())
@@ -133,13 +136,16 @@ auto fvkCamera::disconnect() -> bool
 	{
 		// stop the processing thread.
 		if (p_pt->active())
-		{
 			p_pt->stop();
-			p_pt->writer().stop();
-			std::cout << "[" << p_pt->getDeviceIndex() << "] camera processing thread has been stopped successfully.\n";
-		}
+
+		// the recorder can only be closed when the processing thread does not add frames anymore.
+		joinProcThread();
+		std::cout << "[" << p_pt->getDeviceIndex() << "] camera processing thread has been stopped successfully.\n";
+		p_pt->writer().stop();
 	}
 
+	m_stop_latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stop_start).count();
+
 	return true;
 }
 auto fvkCamera::connect() -> bool
@@ -165,6 +171,37 @@ auto fvkCamera::connect() -> bool
 	return b;
 }
 auto fvkCamera::start() -> bool
+{
+	if (!prepareStart())
+		return false;
+
+	m_ct_thread = fvkJThread(m_stop, [this](const fvkStopToken& token) { p_ct->start(token); });
+	m_ct_handle = m_ct_thread.native_handle();
+
+	m_pt_thread = fvkJThread(m_stop, [this](const fvkStopToken& token) { p_pt->start(token); });
+	m_pt_handle = m_pt_thread.native_handle();
+
+	// so a stop() right after this function is not overridden by the starting threads.
+	p_ct->waitForStarted(2000);
+	p_pt->waitForStarted(2000);
+
+	return true;
+}
+auto fvkCamera::start(fvkExecutor& executor) -> bool
+{
+	if (!prepareStart())
+		return false;
+
+	// both threads begin their run here, and each one wakes up the other one after
+	// an iteration (a new frame for the processing, a free slot for the camera).
+	m_ct_task = fvkThreadTask::start(executor, p_ct, m_stop.get_token());
+	m_pt_task = fvkThreadTask::start(executor, p_pt, m_stop.get_token());
+	m_ct_task->setPeer(m_pt_task);
+	m_pt_task->setPeer(m_ct_task);
+
+	return true;
+}
+auto fvkCamera::prepareStart() -> bool
 {
 	if (!p_ct) 
 		return false;
@@ -172,35 +209,49 @@ auto fvkCamera::start() -> bool
 	if (!p_ct->isOpened())
 		return false;
 
-	// Run some task on new thread. The launch policy std::launch::async
-	// makes sure that the task is run asynchronously on a new thread.
-	//auto future1 = std::async(std::launch::deferred, [&]() { p_ct->start(); });
-	//future1.wait_for(std::chrono::milliseconds(400)); // wait for camera thread to start, then start the processing thread.
-	//auto future2 = std::async(std::launch::deferred, [&]() { p_pt->start(); });
-
-	if (p_stdct)
-		delete p_stdct;
-	p_stdct = new std::thread([this]() { p_ct->start(); });
-#if defined(_WIN32)
-	m_ct_handle = p_stdct->native_handle();	// must save native handle before calling join() or detach().
-#else
-	m_ct_handle = nullptr;
-#endif // _WIN32
-	p_stdct->detach();
-
-	if (p_stdpt)
-		delete p_stdpt;
-	p_stdpt = new std::thread([this]() { p_pt->start(); });
-#if defined(_WIN32)
-	m_pt_handle = p_stdpt->native_handle();	// must save native handle before calling join() or detach().
-#else
-	m_pt_handle = nullptr;
-#endif // _WIN32
-	p_stdpt->detach();
+	// the threads of the previous run must have left, otherwise they would share the buffer with the new ones.
+	if (p_ct->isRunning() || (p_pt && p_pt->isRunning()))
+		return false;
+	joinThreads();	// threads that have left by themselves (for example, at the end of a video).
+
+	// discard the frames of the previous run and open the buffers that were closed by disconnect().
+	if (p_ct->getSemaphoreBuffer())
+		p_ct->getSemaphoreBuffer()->reopen();
+	p_ct->subscribers().reopen();
+
+	// one stop source for both threads of this run, it also closes the buffer to wake them up.
+	m_stop = fvkStopSource();
+	if (p_ct->getSemaphoreBuffer())
+		p_ct->getSemaphoreBuffer()->closeOnStop(m_stop.get_token());
 
 	return true;
 }
 
+void fvkCamera::joinThreads()
+{
+	m_stop.request_stop();
+	joinCamThread();
+	joinProcThread();
+	m_ct_thread = fvkJThread();
+	m_pt_thread = fvkJThread();
+	m_ct_handle = std::thread::native_handle_type();
+	m_pt_handle = std::thread::native_handle_type();
+}
+void fvkCamera::joinCamThread()
+{
+	m_ct_thread.join();
+	if (m_ct_task)
+		m_ct_task->wait();
+	m_ct_task.reset();
+}
+void fvkCamera::joinProcThread()
+{
+	m_pt_thread.join();
+	if (m_pt_task)
+		m_pt_task->wait();
+	m_pt_task.reset();
+}
+
 auto fvkCamera::isConnected() const -> bool
 {
 	if (!p_ct) return false;
@@ -247,6 +298,56 @@ auto fvkCamera::getDelay() const -> int
 	if (!p_ct) return 0;
 	return p_ct->getDelay();
 }
+void fvkCamera::setFrameRate(const double fps) const
+{
+	if (!p_ct) return;
+	p_ct->setFrameRate(fps);
+}
+auto fvkCamera::getFrameRate() const -> double
+{
+	if (!p_ct) return 0.0;
+	return p_ct->getFrameRate();
+}
+void fvkCamera::setPacing(const fvkPacing pacing) const
+{
+	if (!p_ct) return;
+	p_ct->setPacing(pacing);
+}
+auto fvkCamera::getPacing() const -> fvkPacing
+{
+	if (!p_ct) return fvkPacing::CatchUp;
+	return p_ct->getPacing();
+}
+void fvkCamera::setCamThreadAffinity(const std::vector<int>& cpus) const
+{
+	if (!p_ct) return;
+	p_ct->setAffinity(cpus);
+}
+void fvkCamera::setProcThreadAffinity(const std::vector<int>& cpus) const
+{
+	if (!p_pt) return;
+	p_pt->setAffinity(cpus);
+}
+void fvkCamera::setCamThreadScheduling(const fvkSchedPolicy policy, const int priority) const
+{
+	if (!p_ct) return;
+	p_ct->setScheduling(policy, priority);
+}
+void fvkCamera::setProcThreadScheduling(const fvkSchedPolicy policy, const int priority) const
+{
+	if (!p_pt) return;
+	p_pt->setScheduling(policy, priority);
+}
+void fvkCamera::setCamThreadName(const std::string& name) const
+{
+	if (!p_ct) return;
+	p_ct->setName(name);
+}
+void fvkCamera::setProcThreadName(const std::string& name) const
+{
+	if (!p_pt) return;
+	p_pt->setName(name);
+}
 void fvkCamera::setSyncEnabled(const bool b) const
 {
 	if (!p_ct) return;
@@ -258,10 +359,187 @@ auto fvkCamera::isSyncEnabled() const -> bool
 	return p_ct->isSyncEnabled();
 }
 
+void fvkCamera::setBufferBackend(const fvkBufferBackend backend) const
+{
+	if (!p_ct || !p_ct->getSemaphoreBuffer()) return;
+	if (backend == fvkBufferBackend::SpscRing && p_pt && p_pt->getWorkerCount() > 1)
+	{
+		std::cout << "[" << p_ct->getDeviceIndex() << "] the ring buffer has only one consumer, it can not be used with several workers.\n";
+		return;
+	}
+	p_ct->getSemaphoreBuffer()->setBackend(backend);
+}
+auto fvkCamera::getBufferBackend() const -> fvkBufferBackend
+{
+	if (!p_ct || !p_ct->getSemaphoreBuffer()) return fvkBufferBackend::Queue;
+	return p_ct->getSemaphoreBuffer()->getBackend();
+}
+void fvkCamera::setBufferCapacity(const std::size_t capacity) const
+{
+	if (!p_ct || !p_ct->getSemaphoreBuffer()) return;
+	p_ct->getSemaphoreBuffer()->setCapacity(capacity);
+	reserveFrames();
+}
+auto fvkCamera::getBufferCapacity() const -> std::size_t
+{
+	if (!p_ct || !p_ct->getSemaphoreBuffer()) return 0;
+	return p_ct->getSemaphoreBuffer()->getCapacity();
+}
+void fvkCamera::setBufferPolicy(const fvkBufferPolicy policy) const
+{
+	if (!p_ct || !p_ct->getSemaphoreBuffer()) return;
+	p_ct->getSemaphoreBuffer()->setPolicy(policy);
+}
+auto fvkCamera::getBufferPolicy() const -> fvkBufferPolicy
+{
+	if (!p_ct || !p_ct->getSemaphoreBuffer()) return fvkBufferPolicy::DropNewest;
+	return p_ct->getSemaphoreBuffer()->getPolicy();
+}
+void fvkCamera::setBackpressure(const fvkBackpressure policy) const
+{
+	if (!p_ct) return;
+	p_ct->setBackpressure(policy);
+}
+auto fvkCamera::getBackpressure() const -> fvkBackpressure
+{
+	if (!p_ct) return fvkBackpressure::None;
+	return p_ct->getBackpressure();
+}
+auto fvkCamera::getBufferStats() const -> fvkBufferStats
+{
+	if (!p_ct || !p_ct->getSemaphoreBuffer()) return fvkBufferStats();
+	return p_ct->getSemaphoreBuffer()->getStats();
+}
+void fvkCamera::resetBufferStats() const
+{
+	if (!p_ct || !p_ct->getSemaphoreBuffer()) return;
+	p_ct->getSemaphoreBuffer()->resetStats();
+}
+void fvkCamera::setBatchSize(const std::size_t n, const unsigned long milliseconds) const
+{
+	if (!p_pt) return;
+	p_pt->setBatchSize(n, milliseconds);
+	if (getBufferCapacity() < n)
+		setBufferCapacity(n);
+	reserveFrames();
+}
+auto fvkCamera::getBatchSize() const -> std::size_t
+{
+	if (!p_pt) return 1;
+	return p_pt->getBatchSize();
+}
+void fvkCamera::setWorkerCount(const std::size_t n) const
+{
+	if (!p_pt) return;
+	p_pt->setWorkerCount(n);
+	reserveFrames();
+}
+auto fvkCamera::getWorkerCount() const -> std::size_t
+{
+	if (!p_pt) return 1;
+	return p_pt->getWorkerCount();
+}
+void fvkCamera::reserveFrames() const
+{
+	if (!p_ct || !p_pt) return;
+
+	// one pooled frame for each slot of the buffer, plus the frames being processed (the frames
+	// of a batch are not in the buffer anymore, and with several workers the processed frames
+	// wait for their turn) and the displayed one. Without a filter, the grabbed frames are the
+	// ones that are published, so the mailbox of the display keeps frames of this pool as well.
+	const auto batch = p_pt->getBatchSize();
+	const auto workers = p_pt->getWorkerCount();
+	const auto processing = (workers > 1 ? 2 * workers * batch : batch) + 1;
+	const auto inflight = getBufferCapacity() + processing + fvkProcessingThread::getMailboxSize();
+	if (p_ct->framePool().getSize() < inflight)
+		p_ct->framePool().setSize(inflight);
+
+	// the filters write the processed frames into their own pool, these are the frames that the
+	// mailbox keeps when a filter runs: the frames being processed, the displayed one, the ones of
+	// the mailbox, plus two for a chain of filters (the zoom output is the input of the flip).
+	const auto processed = processing + fvkProcessingThread::getMailboxSize() + 2;
+	auto& pool = p_pt->imageProcessing().framePool();
+	if (pool.getSize() < processed)
+		pool.setSize(processed);
+}
+
 auto fvkCamera::getFrame() const -> cv::Mat
 {
-	if (!p_pt) return cv::Mat();
-	return p_pt->getFrame();
+	if (!p_ct) return cv::Mat();
+	return p_ct->getFrame();
+}
+auto fvkCamera::subscribe(const std::size_t capacity, const fvkBufferPolicy policy) const -> fvkBroadcastBuffer<fvkFrame>::Subscriber
+{
+	if (!p_ct) return nullptr;
+
+	// the frames held by this consumer must not starve the frame pool.
+	reserveFrames();
+	p_ct->framePool().setSize(p_ct->framePool().getSize() + capacity);
+	return p_ct->subscribers().subscribe(capacity, policy);
+}
+auto fvkCamera::unsubscribe(const fvkBroadcastBuffer<fvkFrame>::Subscriber& s) const -> bool
+{
+	if (!p_ct || !s) return false;
+
+	if (!p_ct->subscribers().unsubscribe(s))
+		return false;
+
+	const auto n = p_ct->framePool().getSize();
+	p_ct->framePool().setSize(n > s->getCapacity() ? n - s->getCapacity() : 0);
+
+	// the next nextFrame() subscribes a new stream, instead of waiting on the detached one.
+	std::lock_guard<std::mutex> lk(m_streammutex);
+	if (m_framestream.buffer() == s)
+		m_framestream = fvkFrameStream();
+	return true;
+}
+auto fvkCamera::frameStream(const std::size_t capacity, const fvkBufferPolicy policy) const -> fvkFrameStream
+{
+	return fvkFrameStream(subscribe(capacity, policy));
+}
+auto fvkCamera::getFrameStream() const -> fvkFrameStream
+{
+	std::lock_guard<std::mutex> lk(m_streammutex);
+	if (!m_framestream.buffer())
+		m_framestream = frameStream(1, fvkBufferPolicy::DropOldest);
+	return m_framestream;
+}
+auto fvkCamera::resetFrameStream() const -> bool
+{
+	fvkFrameStream s;
+	{
+		std::lock_guard<std::mutex> lk(m_streammutex);
+		std::swap(s, m_framestream);
+	}
+	if (!s.buffer())
+		return false;
+
+	// a coroutine that still awaits the stream gets an empty frame.
+	s.buffer()->close();
+	return unsubscribe(s.buffer());
+}
+void fvkCamera::watch(fvkWatchdog& watchdog, const std::chrono::milliseconds& timeout, fvkStallFunc f)
+{
+	if (!p_ct || !p_pt) return;
+	unwatch();
+	p_watchdog = &watchdog;
+
+	// a grab() that hangs can not be interrupted from here, so the stall is only reported.
+	const auto ct = p_ct;
+	watchdog.watch(p_ct, timeout, [ct, f](fvkThread* t, const bool stalled)
+	{
+		if (stalled)
+			std::cout << "[" << ct->getDeviceIndex() << "] camera thread has stalled.\n";
+		if (f) f(t, stalled);
+	});
+	watchdog.watch(p_pt, timeout, f);
+}
+void fvkCamera::unwatch()
+{
+	if (!p_watchdog) return;
+	p_watchdog->unwatch(p_ct);
+	p_watchdog->unwatch(p_pt);
+	p_watchdog = nullptr;
 }
 void fvkCamera::saveFrameOnClick() const
 {
@@ -278,11 +556,21 @@ auto fvkCamera::getFrameOutputLocation() const -> std::string
 	if (!p_pt) return std::string();
 	return p_pt->getFrameOutputLocation();
 }
+void fvkCamera::setVideoOutput(const std::function<void(fvkFrame&, const fvkThreadStats&)> f) const
+{
+	if (!p_pt) return;
+	p_pt->setVideoOutput(f);
+}
 void fvkCamera::setVideoOutput(const std::function<void(cv::Mat&, const fvkThreadStats&)> f) const
 { 
 	if (!p_pt) return;
 	p_pt->setVideoOutput(f);
 }
+auto fvkCamera::getLatestFrame(cv::Mat& frame) const -> bool
+{
+	if (!p_pt) return false;
+	return p_pt->getLatestFrame(frame);
+}
 auto fvkCamera::getAvgFps() const -> int
 {
 	if (!p_pt) return 0;
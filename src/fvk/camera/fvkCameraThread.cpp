@@ -22,17 +22,32 @@ extended in order to make any camera device compatible to this library.
 
 #include <fvk/camera/fvkCameraThread.h>
 
+#include <algorithm>
+#include <iostream>
+
 using namespace R3D;
 
-fvkCameraThread::fvkCameraThread(const int device_index, const cv::Size& frame_size, fvkSemaphoreBuffer<cv::Mat>* buffer) :
+fvkCameraThread::fvkCameraThread(const int device_index, const cv::Size& frame_size, fvkSemaphoreBuffer<fvkFrame>* buffer) :
 	fvkThread(),
 	fvkCameraThreadAbstract(device_index, frame_size),
 	p_buffer(buffer),
 	m_video_output_func(nullptr),
 	m_sync_proc_thread(false),
-	m_rect(cv::Rect(0, 0, 10, 10))
+	m_rect(cv::Rect(0, 0, 10, 10)),
+	m_roi_changed(true),
+	m_roi_valid(false),
+	m_roi_full(false),
+	m_backpressure(fvkBackpressure::None),
+	m_throttle(0),
+	m_nskipped(0),
+	m_bp_gets(0),
+	m_bp_dropped(0),
+	m_reopen(false),
+	m_sequence(0),
+	p_group(nullptr)
 {
-	setDelay(1000 / 33);	// delay between frames (30 fps).
+	setFrameRate(30);	// delay between frames (30 fps).
+	setName("fvk-cap-" + std::to_string(device_index));
 }
 
 void fvkCameraThread::run()
@@ -40,20 +55,143 @@ void fvkCameraThread::run()
 	if (!p_buffer)
 		return;
 
+	if (m_reopen.load() && std::chrono::steady_clock::now() >= m_reopen_time)
+		reopen();
+
+	const auto backpressure = m_backpressure.load();
+	if (backpressure == fvkBackpressure::Throttle)
+	{
+		throttle();
+	}
+	else if (backpressure == fvkBackpressure::Skip && !p_group)
+	{
+		// a frame that nobody takes is not retrieved nor copied.
+		const auto dropped = !m_sync_proc_thread && p_buffer->getPolicy() == fvkBufferPolicy::DropNewest && p_buffer->full();
+		if (dropped && m_subscribers.empty() && !m_video_output_func)
+		{
+			if (skip())
+			{
+				m_sequence++;		// a gap in the sequence of the delivered frames.
+				m_nskipped++;
+			}
+			return;
+		}
+	}
+
+	// all the cameras of a group latch their frames at the same instant,
+	// then each one decodes its own frame on its own thread.
+	std::uint64_t set = 0;
+	if (p_group && !p_group->arrive(set, [this]() { return !active(); }))
+		return;
+
+	// the capture time is taken when the device has handed over the frame, before it is decoded.
 	cv::Mat f;
+	auto grabbed = latch();
+	const auto captured = std::chrono::steady_clock::now();
+	grabbed = grabbed && retrieve(f);
 
-	if (grab(f))
+	if (grabbed)
 	{
-		m_rectmutex.lock();
-		const auto r = m_rect;
-		m_rectmutex.unlock();
+		fvkFrame frame;
+		frame.capture_time = captured;
+		frame.device_time = timestamp();
+		frame.sequence = m_sequence++;
+		frame.camera = m_device_index;
 
-		if ((r.x < 0) || (r.y < 0) || ((r.x + r.width) > f.cols) || ((r.y + r.height) > f.rows) || (r.width < 2) || (r.height < 2))
+		// the bounds are only checked when the region-of-interest or the frame size changes.
+		if (m_roi_changed.exchange(false) || f.size() != m_roi_frame)
+			updateRoi(f.size());
+		if (!m_roi_valid)
+		{
+			if (p_group)
+				p_group->deliver(set, fvkFrame());
 			return;
+		}
+
+		// the region-of-interest is a view into the grabbed frame.
+		auto roi = m_roi_full ? f : cv::Mat(f, m_roi);
 
-		auto frame = cv::Mat(f, r).clone();
+		// find out if the frame will be dropped before copying it:
+		// either the buffer has no room for it (and there is no other subscriber),
+		// or all the pooled frames are still in use.
+		// in sync (blocking) mode every frame must be delivered, so a new frame is allocated
+		// when the pool is exhausted.
+		const auto block = m_sync_proc_thread || p_buffer->getPolicy() == fvkBufferPolicy::Block;
+		const auto deliver = block || p_buffer->getPolicy() != fvkBufferPolicy::DropNewest || !p_buffer->full();
+		const auto fanout = !m_subscribers.empty();
 
-		p_buffer->put(frame, m_sync_proc_thread);
+		// a frame that belongs to this thread is handed out as it is, otherwise
+		// the view is copied once into a contiguous pooled frame.
+		auto handed = false;
+		if (deliver || fanout)
+		{
+			if (isFrameOwned())
+			{
+				frame.image = roi;
+				handed = true;
+			}
+			else
+			{
+				// with DropOldest the newest frame is never dropped: the oldest queued frame is
+				// discarded to free its pooled frame, a new one is allocated if that is still in use.
+				const auto newest = p_buffer->getPolicy() == fvkBufferPolicy::DropOldest;
+				auto pooled = m_pool.acquire(roi.size(), f.type(), frame.image);
+				if (!pooled && newest && p_buffer->dropOldest())
+					pooled = m_pool.acquire(roi.size(), f.type(), frame.image);
+
+				if (pooled || block || newest)
+				{
+					roi.copyTo(frame.image);
+					handed = true;
+				}
+			}
+		}
+
+		if (handed)
+		{
+			// the frame is moved to the last one who needs it, so its reference
+			// count is not touched for nothing. the frame set and the display come last.
+			const auto kept = m_video_output_func || p_group;
+			if (deliver)
+			{
+				if (fanout || kept)
+					p_buffer->put(frame, m_sync_proc_thread);
+				else
+					p_buffer->put(std::move(frame), m_sync_proc_thread);
+			}
+
+			// all the subscribers share the same frame data.
+			if (fanout)
+			{
+				if (kept)
+					m_subscribers.put(frame);
+				else
+					m_subscribers.put(std::move(frame));
+			}
+		}
+		else
+		{
+			frame.image = roi;	// the dropped frame is only shown, no copy is needed.
+		}
+
+		// a frame that never reaches put() is still a dropped frame for the statistics.
+		if (!deliver || !handed)
+			p_buffer->countDropNewest();
+
+		// the frame set keeps the frame, so it needs its own copy when the device reuses the grabbed one.
+		if (p_group)
+		{
+			if (handed || isFrameOwned())
+			{
+				p_group->deliver(set, frame);
+			}
+			else
+			{
+				auto copy = frame;
+				copy.image = roi.clone();
+				p_group->deliver(set, std::move(copy));
+			}
+		}
 
 		// emit signal to inform to image box for the new frame.
 		if (m_video_output_func)
@@ -61,38 +199,73 @@ void fvkCameraThread::run()
 	}
 	else
 	{
+		if (p_group)
+			p_group->deliver(set, fvkFrame());
+
 #ifdef _DEBUG
 		std::cout << "Camera # " << m_device_index << " could not grab the frame.\n";
 #endif // _DEBUG
 	}
 }
 
-void fvkCameraThread::setVideoOutput(const std::function<void(cv::Mat&, const fvkThreadStats&)> f)
+void fvkCameraThread::setVideoOutput(const std::function<void(fvkFrame&, const fvkThreadStats&)> f)
 {
 	m_video_output_func = std::move(f);
 }
+void fvkCameraThread::setVideoOutput(const std::function<void(cv::Mat&, const fvkThreadStats&)> f)
+{
+	if (!f)
+		m_video_output_func = nullptr;
+	else
+		m_video_output_func = [f](fvkFrame& frame, const fvkThreadStats& stats) { f(frame.image, stats); };
+}
 
 auto fvkCameraThread::getFrame() -> cv::Mat
 {
-	const auto f = p_buffer->get();
-	if (f.empty())
-		return cv::Mat();
+	// subscribe to the latest frame on the first call, so the frames of the
+	// processing thread are not stolen.
+	m_latestmutex.lock();
+	if (!m_latest)
+	{
+		m_latest = m_subscribers.subscribe(1, fvkBufferPolicy::DropOldest);
+		m_pool.setSize(m_pool.getSize() + 1);
+	}
+	const auto latest = m_latest;
+	m_latestmutex.unlock();
 
-	const auto r = getRoi();
-	if ((r.x < 0) || (r.y < 0) || ((r.x + r.width) > f.cols) || ((r.y + r.height) > f.rows) || (r.width < 2) || (r.height < 2))
+	// the region-of-interest has been applied by run() already, the frame data is shared
+	// with the processing thread and the other subscribers, so the caller gets its own copy.
+	const auto f = latest->get().image;
+	if (f.empty())
 		return cv::Mat();
 
-	return cv::Mat(f, r).clone();
+	return f.clone();
 }
 void fvkCameraThread::resetRoi()
 {
 	std::lock_guard<std::mutex> locker(m_rectmutex);
 	m_rect = cv::Rect(0, 0, m_frame_size.width, m_frame_size.height);
+	m_roi_changed = true;
 }
 void fvkCameraThread::setRoi(const cv::Rect& roi)
 {
 	std::lock_guard<std::mutex> locker(m_rectmutex);
 	m_rect = roi;
+	m_roi_changed = true;
+}
+void fvkCameraThread::updateRoi(const cv::Size& frame_size)
+{
+	m_rectmutex.lock();
+	m_roi = m_rect;
+	m_rectmutex.unlock();
+
+	const auto r = m_roi;
+	m_roi_frame = frame_size;
+	m_roi_valid = (r.x >= 0) && (r.y >= 0) && ((r.x + r.width) <= frame_size.width) && ((r.y + r.height) <= frame_size.height) && (r.width >= 2) && (r.height >= 2);
+	m_roi_full = m_roi_valid && r == cv::Rect(0, 0, frame_size.width, frame_size.height);
+
+	if (!m_roi_valid)
+		std::cout << "[" << m_device_index << "] region of interest is out of the " << frame_size.width << "x" << frame_size.height << " frame.\n";
 }
 auto fvkCameraThread::getRoi() -> cv::Rect
 {
@@ -106,4 +279,146 @@ void fvkCameraThread::setSyncEnabled(const bool b)
 auto fvkCameraThread::isSyncEnabled() const -> bool
 {
 	return m_sync_proc_thread;
+}
+auto fvkCameraThread::skip() -> bool
+{
+	cv::Mat f;
+	return grab(f);
+}
+auto fvkCameraThread::timestamp() -> double
+{
+	return -1.0;
+}
+auto fvkCameraThread::setGrabGroup(fvkGrabGroup* group) -> bool
+{
+	if (isRunning())
+		return false;
+
+	// the frame set that waits for the other cameras holds one more frame.
+	if (!p_group && group)
+		m_pool.setSize(m_pool.getSize() + 1);
+	else if (p_group && !group && m_pool.getSize() > 0)
+		m_pool.setSize(m_pool.getSize() - 1);
+
+	p_group = group;
+	return true;
+}
+auto fvkCameraThread::isFrameOwned() const -> bool
+{
+	return false;
+}
+auto fvkCameraThread::latch() -> bool
+{
+	return grab(m_latched);
+}
+auto fvkCameraThread::retrieve(cv::Mat& frame) -> bool
+{
+	frame = m_latched;
+	m_latched.release();
+	return !frame.empty();
+}
+void fvkCameraThread::setBackpressure(const fvkBackpressure policy)
+{
+	m_backpressure = policy;
+	if (policy != fvkBackpressure::Throttle)
+		m_throttle = 0;
+}
+auto fvkCameraThread::getBackpressure() const -> fvkBackpressure
+{
+	return m_backpressure;
+}
+auto fvkCameraThread::getThrottledFrameRate() const -> double
+{
+	const auto throttled = m_throttle.load();
+	return throttled > 0 ? 1e9 / static_cast<double>(throttled) : getFrameRate();
+}
+auto fvkCameraThread::getSkippedFrames() const -> unsigned long long
+{
+	return m_nskipped;
+}
+void fvkCameraThread::onStart()
+{
+	m_throttle = 0;
+	m_nskipped = 0;
+	m_bp_time = std::chrono::steady_clock::now();
+	m_bp_gets = 0;
+	m_bp_dropped = 0;
+	if (p_buffer)
+	{
+		const auto s = p_buffer->getStats();
+		m_bp_gets = s.ngets;
+		m_bp_dropped = s.ndropped();
+	}
+
+	if (p_group)
+		p_group->join();
+}
+void fvkCameraThread::onStop()
+{
+	// the other cameras of the group do not wait for this one anymore.
+	if (p_group)
+		p_group->leave();
+}
+auto fvkCameraThread::getIterationDelay() -> long long
+{
+	const auto delay = fvkThread::getIterationDelay();
+	const auto throttled = m_throttle.load();
+	return throttled > delay ? throttled : delay;
+}
+void fvkCameraThread::throttle()
+{
+	// the throughput of the consumer is measured over half a second at least,
+	// so a single slow frame does not change the rate.
+	const auto now = std::chrono::steady_clock::now();
+	const auto elapsed = std::chrono::duration<double>(now - m_bp_time).count();
+	if (elapsed < 0.5)
+		return;
+
+	const auto s = p_buffer->getStats();
+	const auto gets = s.ngets - m_bp_gets;
+	const auto dropped = s.ndropped() - m_bp_dropped;
+	m_bp_time = now;
+	m_bp_gets = s.ngets;
+	m_bp_dropped = s.ndropped();
+
+	auto delay = m_throttle.load();
+	if (dropped > 0 || s.occupancy >= s.capacity)
+	{
+		// the consumer is behind, grab as fast as it takes the frames (but at least one frame per second).
+		const auto rate = std::max(static_cast<double>(gets) / elapsed, 1.0);
+		delay = static_cast<long long>(1e9 / rate);
+	}
+	else if (delay > 0 && s.occupancy == 0)
+	{
+		// the consumer waits for frames, speed up again.
+		delay = delay * 3 / 4;
+	}
+
+	// never faster than the frame rate.
+	m_throttle = delay > fvkThread::getIterationDelay() ? delay : 0;
+}
+void fvkCameraThread::requestReopen()
+{
+	m_reopen = true;
+}
+void fvkCameraThread::reopen()
+{
+	m_reopen = false;
+	close();
+	if (open())
+	{
+		std::cout << "[" << m_device_index << "] camera has been reopened.\n";
+		return;
+	}
+
+	std::cout << "[" << m_device_index << "] camera could not be reopened, trying again in a second.\n";
+	m_reopen_time = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+	m_reopen = true;
+}
+auto fvkCameraThread::ready() -> bool
+{
+	if (!p_buffer || p_buffer->isClosed())
+		return true;
+	const auto block = m_sync_proc_thread || p_buffer->getPolicy() == fvkBufferPolicy::Block;
+	return !block || !p_buffer->full();
 }
\ No newline at end of file
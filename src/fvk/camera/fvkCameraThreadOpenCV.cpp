@@ -23,7 +23,7 @@ purpose:	class to create handle opencv video camera.
 
 using namespace R3D;
 
-fvkCameraThreadOpenCV::fvkCameraThreadOpenCV(const int device_index, const cv::Size& frame_size, const int api, fvkSemaphoreBuffer<cv::Mat>* buffer) :
+fvkCameraThreadOpenCV::fvkCameraThreadOpenCV(const int device_index, const cv::Size& frame_size, const int api, fvkSemaphoreBuffer<fvkFrame>* buffer) :
 	fvkCameraThread(device_index, frame_size, buffer),
 	m_videocapture_api(api),
 	m_filepath(""),
@@ -31,7 +31,7 @@ fvkCameraThreadOpenCV::fvkCameraThreadOpenCV(const int device_index, const cv::S
 {
 }
 
-fvkCameraThreadOpenCV::fvkCameraThreadOpenCV(const std::string& video_file, const cv::Size& frame_size, const int api, fvkSemaphoreBuffer<cv::Mat>* buffer) :
+fvkCameraThreadOpenCV::fvkCameraThreadOpenCV(const std::string& video_file, const cv::Size& frame_size, const int api, fvkSemaphoreBuffer<fvkFrame>* buffer) :
 	fvkCameraThread(0, frame_size, buffer),
 	m_videocapture_api(api),
 	m_filepath(video_file),
@@ -92,7 +92,7 @@ auto fvkCameraThreadOpenCV::open(const std::string& file_name) -> bool
 	m_frame_size.width = static_cast<int>(m_cam.get(cv::CAP_PROP_FRAME_WIDTH));
 	m_frame_size.height = static_cast<int>(m_cam.get(cv::CAP_PROP_FRAME_HEIGHT));
 
-	setDelay(static_cast<int>(1000.0 / m_cam.get(cv::CAP_PROP_FPS)));	// delay between frames.
+	setFrameRate(m_cam.get(cv::CAP_PROP_FPS));	// delay between frames.
 
 	m_filepath = file_name;
 
@@ -123,6 +123,13 @@ auto fvkCameraThreadOpenCV::close() -> bool
 }
 
 auto fvkCameraThreadOpenCV::grab(cv::Mat& frame) -> bool
+{
+	if (!skip())
+		return false;
+
+	return m_cam.retrieve(frame);				// decode the grabbed frame.
+}
+auto fvkCameraThreadOpenCV::skip() -> bool
 {
 	// grab from the video file.
 	if (!m_filepath.empty())					// if there is a *.avi video file, then grab from it.
@@ -133,19 +140,32 @@ auto fvkCameraThreadOpenCV::grab(cv::Mat& frame) -> bool
 			{
 				setPosFrames(0);				// reset the camera frame to 0.
 				setFrameNumber(0);				// reset the camera frame to 0.
-				return false;
 			}
-		}
-	}
-	else										// otherwise, grab from the camera device.
-	{
-		if (!m_cam.grab())						// capture frame (if available).
 			return false;
+		}
+		return true;
 	}
 
+	// otherwise, grab from the camera device.
+	return m_cam.grab();						// capture frame (if available).
+}
+
+auto fvkCameraThreadOpenCV::latch() -> bool
+{
+	return skip();
+}
+auto fvkCameraThreadOpenCV::retrieve(cv::Mat& frame) -> bool
+{
 	return m_cam.retrieve(frame);
 }
 
+auto fvkCameraThreadOpenCV::timestamp() -> double
+{
+	// the camera backends that have no timestamp return 0.
+	const auto t = m_cam.get(cv::CAP_PROP_POS_MSEC);
+	return t > 0 || !m_filepath.empty() ? t : -1.0;
+}
+
 void fvkCameraThreadOpenCV::repeat(const bool b)
 {
 	m_isrepeat = b;
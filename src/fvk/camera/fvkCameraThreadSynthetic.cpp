@@ -0,0 +1,277 @@
+/*********************************************************************************
+created:	2026/10/18   08:30PM
+filename: 	fvkCameraThreadSynthetic.cpp
+file base:	fvkCameraThreadSynthetic
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	camera thread that generates deterministic test patterns instead of
+grabbing from a device.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkCameraThreadSynthetic.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace R3D;
+
+namespace
+{
+	const auto pi = 3.14159265358979323846;
+
+	// convert a BGR (or gray or BGRA) 8-bit image to the given type.
+	auto toType(const cv::Mat& src, const int type) -> cv::Mat
+	{
+		cv::Mat bgr;
+		if (src.channels() == 1)
+			cv::cvtColor(src, bgr, cv::COLOR_GRAY2BGR);
+		else if (src.channels() == 4)
+			cv::cvtColor(src, bgr, cv::COLOR_BGRA2BGR);
+		else
+			bgr = src;
+
+		cv::Mat m;
+		const auto cn = CV_MAT_CN(type);
+		if (cn == 1)
+			cv::cvtColor(bgr, m, cv::COLOR_BGR2GRAY);
+		else if (cn == 4)
+			cv::cvtColor(bgr, m, cv::COLOR_BGR2BGRA);
+		else
+			m = bgr;
+
+		const auto depth = CV_MAT_DEPTH(type);
+		if (depth == CV_8U)
+			return m;
+
+		const auto scale = depth == CV_16U ? 257.0 : depth == CV_32F || depth == CV_64F ? 1.0 / 255.0 : 1.0;
+		cv::Mat d;
+		m.convertTo(d, depth, scale);
+		return d;
+	}
+}
+
+fvkCameraThreadSynthetic::fvkCameraThreadSynthetic(const int device_index, const cv::Size& frame_size, const int type, const fvkSyntheticPattern pattern, fvkSemaphoreBuffer<fvkFrame>* buffer) :
+	fvkCameraThread(device_index, frame_size, buffer),
+	m_isopen(false),
+	m_type(type),
+	m_pattern(pattern),
+	m_seed(0),
+	m_latency(0),
+	m_jitter(0),
+	m_index(0),
+	m_timestamp(-1),
+	m_latched_index(-1),
+	m_owned(false)
+{
+}
+
+fvkCameraThreadSynthetic::~fvkCameraThreadSynthetic()
+{
+	stop();
+	fvkCameraThreadSynthetic::close();
+}
+
+auto fvkCameraThreadSynthetic::open() -> bool
+{
+	return open(m_device_index);
+}
+auto fvkCameraThreadSynthetic::open(const int device_index) -> bool
+{
+	if (m_frame_size.width <= 0 || m_frame_size.height <= 0)
+		m_frame_size = cv::Size(640, 480);
+
+	m_rng.seed(m_seed);
+	m_index = 0;
+	m_open_time = std::chrono::steady_clock::now();
+	m_timestamp = -1;
+	m_latched_index = -1;
+	createBackground();
+	if (m_pattern == fvkSyntheticPattern::Face)
+		createFace();
+
+	m_device_index = device_index;
+	m_isopen = true;
+	return true;
+}
+auto fvkCameraThreadSynthetic::isOpened() const -> bool
+{
+	return m_isopen;
+}
+auto fvkCameraThreadSynthetic::close() -> bool
+{
+	if (!m_isopen)
+		return false;
+
+	m_isopen = false;
+	return true;
+}
+
+void fvkCameraThreadSynthetic::setLatency(const double latency, const double jitter)
+{
+	m_latency = latency > 0 ? latency : 0.0;
+	m_jitter = jitter > 0 ? jitter : 0.0;
+}
+
+void fvkCameraThreadSynthetic::createBackground()
+{
+	// a colour gradient along the diagonal that repeats every frame width, so a frame
+	// is a view of the background at any offset from 0 to the frame width.
+	const auto w = m_frame_size.width;
+	const auto h = m_frame_size.height;
+
+	std::vector<cv::Vec3b> lut(w);
+	for (auto k = 0; k < w; k++)
+	{
+		const auto a = 2.0 * pi * k / w;
+		for (auto c = 0; c < 3; c++)
+			lut[k][c] = cv::saturate_cast<unsigned char>(127.5 * (1.0 + std::sin(a + c * 2.0 * pi / 3.0)));
+	}
+
+	cv::Mat bgr(h, 2 * w, CV_8UC3);
+	for (auto y = 0; y < h; y++)
+	{
+		auto row = bgr.ptr<cv::Vec3b>(y);
+		for (auto x = 0; x < 2 * w; x++)
+			row[x] = lut[(x + y / 2) % w];
+	}
+
+	m_background = toType(bgr, m_type);
+}
+
+void fvkCameraThreadSynthetic::createFace()
+{
+	// a third of the frame height.
+	const auto size = std::max(m_frame_size.height / 3, 16);
+
+	cv::Mat face;
+	if (!m_face_image.empty())
+	{
+		cv::resize(m_face_image, face, cv::Size(size * m_face_image.cols / std::max(m_face_image.rows, 1), size));
+	}
+	else
+	{
+		// a simple drawn face: skin, eyes, eyebrows, nose and mouth.
+		face = cv::Mat(size, size * 3 / 4, CV_8UC3, cv::Scalar(40, 40, 40));
+		const auto c = cv::Point(face.cols / 2, face.rows / 2);
+		const auto s = size / 100.0;
+		cv::ellipse(face, c, cv::Size(static_cast<int>(36 * s), static_cast<int>(48 * s)), 0, 0, 360, cv::Scalar(130, 160, 215), -1, cv::LINE_AA);
+		for (const auto dx : { -14, 14 })
+		{
+			cv::circle(face, c + cv::Point(static_cast<int>(dx * s), static_cast<int>(-12 * s)), static_cast<int>(6 * s), cv::Scalar(255, 255, 255), -1, cv::LINE_AA);
+			cv::circle(face, c + cv::Point(static_cast<int>(dx * s), static_cast<int>(-12 * s)), static_cast<int>(3 * s), cv::Scalar(60, 40, 20), -1, cv::LINE_AA);
+			cv::line(face, c + cv::Point(static_cast<int>((dx - 8) * s), static_cast<int>(-24 * s)), c + cv::Point(static_cast<int>((dx + 8) * s), static_cast<int>(-24 * s)), cv::Scalar(40, 50, 70), std::max(1, static_cast<int>(3 * s)), cv::LINE_AA);
+		}
+		cv::line(face, c + cv::Point(0, static_cast<int>(-6 * s)), c + cv::Point(static_cast<int>(-4 * s), static_cast<int>(8 * s)), cv::Scalar(90, 110, 170), std::max(1, static_cast<int>(2 * s)), cv::LINE_AA);
+		cv::ellipse(face, c + cv::Point(0, static_cast<int>(22 * s)), cv::Size(static_cast<int>(14 * s), static_cast<int>(6 * s)), 0, 0, 180, cv::Scalar(60, 60, 160), std::max(1, static_cast<int>(3 * s)), cv::LINE_AA);
+	}
+
+	// the face must fit in the frame.
+	if (face.cols > m_frame_size.width || face.rows > m_frame_size.height)
+		cv::resize(face, face, cv::Size(std::min(face.cols, m_frame_size.width), std::min(face.rows, m_frame_size.height)));
+
+	m_face = toType(face, m_type);
+}
+
+void fvkCameraThreadSynthetic::wait()
+{
+	auto ms = m_latency.load();
+	const auto jitter = m_jitter.load();
+	if (jitter > 0)
+		ms += std::uniform_real_distribution<double>(-jitter, jitter)(m_rng);
+	if (ms > 0)
+		std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms));
+}
+
+auto fvkCameraThreadSynthetic::skip() -> bool
+{
+	if (!m_isopen)
+		return false;
+
+	wait();
+	m_index++;
+	return true;
+}
+
+auto fvkCameraThreadSynthetic::timestamp() -> double
+{
+	return m_timestamp;
+}
+auto fvkCameraThreadSynthetic::isFrameOwned() const -> bool
+{
+	return m_owned;
+}
+
+auto fvkCameraThreadSynthetic::grab(cv::Mat& frame) -> bool
+{
+	return latch() && retrieve(frame);
+}
+auto fvkCameraThreadSynthetic::latch() -> bool
+{
+	if (!m_isopen)
+		return false;
+
+	wait();
+	m_timestamp = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_open_time).count();
+	m_latched_index = static_cast<long long>(m_index++);
+	return true;
+}
+auto fvkCameraThreadSynthetic::retrieve(cv::Mat& frame) -> bool
+{
+	if (!m_isopen || m_latched_index < 0)
+		return false;
+
+	const auto n = static_cast<unsigned long long>(m_latched_index);
+	m_latched_index = -1;
+	const auto w = m_frame_size.width;
+	const auto h = m_frame_size.height;
+
+	// the gradient moves by 4 pixels per frame, a frame is just a view of the background.
+	const auto offset = static_cast<int>((n * 4) % static_cast<unsigned long long>(w));
+	const cv::Mat background(m_background, cv::Rect(offset, 0, w, h));
+	m_owned = m_pattern != fvkSyntheticPattern::Gradient;
+	if (!m_owned)
+	{
+		frame = background;
+		return true;
+	}
+
+	// the generated frames come from the frame pool, so they are counted with the buffered ones.
+	cv::Mat out;
+	if (!m_pool.acquire(m_frame_size, m_type, out))
+		out.create(h, w, m_type);
+
+	if (m_pattern == fvkSyntheticPattern::Noise)
+	{
+		const auto depth = CV_MAT_DEPTH(m_type);
+		const auto high = depth == CV_8U ? 256.0 : depth == CV_16U ? 65536.0 : 1.0;
+		cv::RNG rng(static_cast<std::uint64_t>(m_seed) * 0x9E3779B97F4A7C15ULL + n + 1);
+		rng.fill(out, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(high));
+	}
+	else
+	{
+		// the face moves along a Lissajous curve over the moving background.
+		background.copyTo(out);
+		const auto t = static_cast<double>(n);
+		const auto x = static_cast<int>((w - m_face.cols) * 0.5 * (1.0 + std::sin(t * 0.050)));
+		const auto y = static_cast<int>((h - m_face.rows) * 0.5 * (1.0 + std::sin(t * 0.037)));
+		m_face.copyTo(out(cv::Rect(x, y, m_face.cols, m_face.rows)));
+	}
+
+	frame = out;
+	return true;
+}
@@ -0,0 +1,520 @@
+/*********************************************************************************
+created:	2026/10/18   09:15PM
+filename: 	fvkCameraThreadV4L2.cpp
+file base:	fvkCameraThreadV4L2
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	camera thread that streams from a Video4Linux2 device through memory-mapped buffers.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkCameraThreadV4L2.h>
+
+#if defined(__linux__)
+
+#include <linux/videodev2.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+using namespace R3D;
+
+namespace
+{
+	// type of the raw frames of a pixel format, -1 if the format is not supported.
+	auto rawType(const std::uint32_t pixelformat) -> int
+	{
+		switch (pixelformat)
+		{
+		case V4L2_PIX_FMT_YUYV:
+		case V4L2_PIX_FMT_UYVY:
+			return CV_8UC2;
+		case V4L2_PIX_FMT_GREY:
+		case V4L2_PIX_FMT_MJPEG:
+			return CV_8UC1;
+		case V4L2_PIX_FMT_BGR24:
+			return CV_8UC3;
+		default:
+			return -1;
+		}
+	}
+
+	auto toString(const std::uint32_t pixelformat) -> std::string
+	{
+		std::string s(4, ' ');
+		for (auto i = 0; i < 4; i++)
+			s[i] = static_cast<char>((pixelformat >> (8 * i)) & 0xFF);
+		return s;
+	}
+}
+
+fvkCameraThreadV4L2::fvkCameraThreadV4L2(const int device_index, const cv::Size& frame_size, fvkSemaphoreBuffer<fvkFrame>* buffer) :
+	fvkCameraThread(device_index, frame_size, buffer),
+	m_path(""),
+	m_pixelformat(V4L2_PIX_FMT_YUYV),
+	m_nbuffers(4),
+	m_convert(true),
+	m_timeout(1000),
+	m_fd(-1),
+	m_streaming(false),
+	m_bytesperline(0),
+	m_driver_sequence(-1),
+	m_timestamp(-1),
+	m_converted(false),
+	m_latched_index(-1),
+	m_latched_bytes(0),
+	m_nqueued(0),
+	m_nlost(0)
+{
+}
+
+fvkCameraThreadV4L2::fvkCameraThreadV4L2(const std::string& device_path, const cv::Size& frame_size, fvkSemaphoreBuffer<fvkFrame>* buffer) :
+	fvkCameraThreadV4L2(0, frame_size, buffer)
+{
+	m_path = device_path;
+}
+
+fvkCameraThreadV4L2::~fvkCameraThreadV4L2()
+{
+	stop();
+	fvkCameraThreadV4L2::close();
+	reap();		// a buffer that is still referred to by a consumer stays mapped.
+}
+
+auto fvkCameraThreadV4L2::open() -> bool
+{
+	return open(m_device_index);
+}
+auto fvkCameraThreadV4L2::open(const int device_index) -> bool
+{
+	if (m_fd >= 0)
+		release();
+
+	// the buffers of the previous run must be unmapped before the driver gives new ones.
+	reap();
+
+	const auto path = m_path.empty() ? "/dev/video" + std::to_string(device_index) : m_path;
+	const auto fail = [&](const char* what)
+	{
+		std::cout << "[" << device_index << "] " << path << ": " << what << " (" << std::strerror(errno) << ").\n";
+		release();
+		return false;
+	};
+
+	m_fd = deviceOpen(path);
+	if (m_fd < 0)
+		return fail("could not open the device");
+
+	v4l2_capability cap{};
+	if (deviceIoctl(m_fd, VIDIOC_QUERYCAP, &cap) < 0)
+		return fail("is not a V4L2 device");
+	const auto caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+	if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING))
+	{
+		errno = ENOTSUP;
+		return fail("is not a streaming capture device");
+	}
+
+	// the driver adjusts the size and the format to the nearest ones it supports.
+	v4l2_format fmt{};
+	fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (deviceIoctl(m_fd, VIDIOC_G_FMT, &fmt) < 0)
+		return fail("could not get the format");
+	if (m_frame_size.width > 0 && m_frame_size.height > 0)
+	{
+		fmt.fmt.pix.width = static_cast<std::uint32_t>(m_frame_size.width);
+		fmt.fmt.pix.height = static_cast<std::uint32_t>(m_frame_size.height);
+	}
+	fmt.fmt.pix.pixelformat = m_pixelformat;
+	fmt.fmt.pix.field = V4L2_FIELD_ANY;
+	if (deviceIoctl(m_fd, VIDIOC_S_FMT, &fmt) < 0)
+		return fail("could not set the format");
+
+	m_frame_size = cv::Size(static_cast<int>(fmt.fmt.pix.width), static_cast<int>(fmt.fmt.pix.height));
+	m_pixelformat = fmt.fmt.pix.pixelformat;
+	m_bytesperline = fmt.fmt.pix.bytesperline;
+	if (rawType(m_pixelformat) < 0)
+	{
+		errno = ENOTSUP;
+		return fail(("the pixel format " + toString(m_pixelformat) + " is not supported").c_str());
+	}
+
+	v4l2_requestbuffers req{};
+	req.count = static_cast<std::uint32_t>(m_nbuffers > 2 ? m_nbuffers : 2);
+	req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	req.memory = V4L2_MEMORY_MMAP;
+	if (deviceIoctl(m_fd, VIDIOC_REQBUFS, &req) < 0)
+		return fail("could not request the buffers");
+	if (req.count < 2)
+	{
+		errno = ENOMEM;
+		return fail("not enough buffers");
+	}
+
+	for (std::uint32_t i = 0; i < req.count; i++)
+	{
+		v4l2_buffer buf{};
+		buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		buf.memory = V4L2_MEMORY_MMAP;
+		buf.index = i;
+		if (deviceIoctl(m_fd, VIDIOC_QUERYBUF, &buf) < 0)
+			return fail("could not query a buffer");
+
+		Buffer b;
+		b.start = deviceMap(m_fd, buf.length, buf.m.offset);
+		b.length = buf.length;
+		b.queued = false;
+		if (!b.start)
+			return fail("could not map a buffer");
+		m_buffers.push_back(b);
+
+		// the frame must fit in the buffer.
+		if (m_pixelformat != V4L2_PIX_FMT_MJPEG && m_bytesperline * static_cast<std::size_t>(m_frame_size.height) > b.length)
+		{
+			errno = EINVAL;
+			return fail("the buffers are smaller than the frames");
+		}
+		m_buffers.back().mat = wrap(m_buffers.back());
+
+		if (!queue(i))
+			return fail("could not queue a buffer");
+	}
+	m_nbuffers = m_buffers.size();
+
+	auto type = static_cast<int>(V4L2_BUF_TYPE_VIDEO_CAPTURE);
+	if (deviceIoctl(m_fd, VIDIOC_STREAMON, &type) < 0)
+		return fail("could not start the streaming");
+
+	m_driver_sequence = -1;
+	m_nlost = 0;
+	m_device_index = device_index;
+	m_streaming = true;
+	return true;
+}
+auto fvkCameraThreadV4L2::isOpened() const -> bool
+{
+	return m_streaming;
+}
+auto fvkCameraThreadV4L2::close() -> bool
+{
+	if (m_fd < 0)
+		return false;
+
+	release();
+	return true;
+}
+
+void fvkCameraThreadV4L2::release()
+{
+	if (m_streaming)
+	{
+		auto type = static_cast<int>(V4L2_BUF_TYPE_VIDEO_CAPTURE);
+		deviceIoctl(m_fd, VIDIOC_STREAMOFF, &type);		// all the buffers are dequeued.
+		m_streaming = false;
+	}
+
+	// a buffer that a consumer still refers to stays mapped (and its data valid) until
+	// the last reference is gone, it is unmapped by reap() then.
+	for (auto& b : m_buffers)
+	{
+		if (b.mat.empty() || CV_XADD(&b.mat.u->refcount, 0) == 1)
+		{
+			b.mat.release();
+			deviceUnmap(b.start, b.length);
+		}
+		else
+		{
+			m_orphans.push_back(std::move(b));
+		}
+	}
+	m_buffers.clear();
+	m_nqueued = 0;
+	m_latched_index = -1;
+
+	if (m_fd >= 0)
+	{
+		if (m_orphans.empty())
+		{
+			v4l2_requestbuffers req{};
+			req.count = 0;
+			req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+			req.memory = V4L2_MEMORY_MMAP;
+			deviceIoctl(m_fd, VIDIOC_REQBUFS, &req);
+		}
+		deviceClose(m_fd);
+		m_fd = -1;
+	}
+}
+
+void fvkCameraThreadV4L2::reap()
+{
+	for (auto it = m_orphans.begin(); it != m_orphans.end();)
+	{
+		if (CV_XADD(&it->mat.u->refcount, 0) == 1)
+		{
+			it->mat.release();
+			deviceUnmap(it->start, it->length);
+			it = m_orphans.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+auto fvkCameraThreadV4L2::wrap(Buffer& b) const -> cv::Mat
+{
+	// a header that points into the mapped buffer, with a reference count like an allocated cv::Mat,
+	// so the copies of the frame are tracked. USER_ALLOCATED keeps OpenCV from freeing the data.
+	auto u = new cv::UMatData(cv::Mat::getStdAllocator());
+	u->data = u->origdata = static_cast<uchar*>(b.start);
+	u->size = b.length;
+	u->flags |= cv::UMatData::USER_ALLOCATED;
+	u->refcount = 1;
+
+	cv::Mat m;
+	if (m_pixelformat == V4L2_PIX_FMT_MJPEG)
+		m = cv::Mat(1, static_cast<int>(b.length), CV_8UC1, b.start);
+	else
+		m = cv::Mat(m_frame_size.height, m_frame_size.width, rawType(m_pixelformat), b.start, m_bytesperline);
+	m.u = u;
+	return m;
+}
+auto fvkCameraThreadV4L2::view(const Buffer& b, const std::uint32_t bytesused) const -> cv::Mat
+{
+	// a compressed frame only takes the first bytes of the buffer.
+	if (m_pixelformat == V4L2_PIX_FMT_MJPEG)
+		return b.mat.colRange(0, std::min(static_cast<int>(bytesused), b.mat.cols));
+
+	return b.mat;
+}
+
+auto fvkCameraThreadV4L2::queue(const std::size_t index) -> bool
+{
+	v4l2_buffer buf{};
+	buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	buf.memory = V4L2_MEMORY_MMAP;
+	buf.index = static_cast<std::uint32_t>(index);
+	if (deviceIoctl(m_fd, VIDIOC_QBUF, &buf) < 0)
+		return false;
+
+	m_buffers[index].queued = true;
+	m_nqueued++;
+	return true;
+}
+void fvkCameraThreadV4L2::requeue()
+{
+	if (!m_orphans.empty())
+		reap();
+
+	for (std::size_t i = 0; i < m_buffers.size(); i++)
+	{
+		const auto& b = m_buffers[i];
+
+		// reference count is changed atomically by the consumer threads.
+		if (!b.queued && CV_XADD(&b.mat.u->refcount, 0) == 1)
+			queue(i);
+	}
+}
+auto fvkCameraThreadV4L2::dequeue(std::uint32_t& bytesused) -> int
+{
+	if (!m_streaming)
+		return -1;
+
+	requeue();
+
+	// all the buffers are held by the consumers, the driver has nowhere to write a frame.
+	if (m_nqueued == 0)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		return -1;
+	}
+
+	if (deviceWait(m_fd, m_timeout) <= 0)
+		return -1;
+
+	v4l2_buffer buf{};
+	buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	buf.memory = V4L2_MEMORY_MMAP;
+	if (deviceIoctl(m_fd, VIDIOC_DQBUF, &buf) < 0 || buf.index >= m_buffers.size())
+		return -1;
+
+	m_buffers[buf.index].queued = false;
+	m_nqueued--;
+
+	const auto sequence = static_cast<long long>(buf.sequence);
+	if (m_driver_sequence >= 0 && sequence > m_driver_sequence + 1)
+		m_nlost += static_cast<unsigned long long>(sequence - m_driver_sequence - 1);
+	m_driver_sequence = sequence;
+
+	// a corrupted frame goes straight back to the driver.
+	if (buf.flags & V4L2_BUF_FLAG_ERROR)
+	{
+		queue(buf.index);
+		return -1;
+	}
+
+	bytesused = buf.bytesused;
+	m_timestamp = static_cast<double>(buf.timestamp.tv_sec) * 1000.0 + static_cast<double>(buf.timestamp.tv_usec) / 1000.0;
+	return static_cast<int>(buf.index);
+}
+
+auto fvkCameraThreadV4L2::grab(cv::Mat& frame) -> bool
+{
+	return latch() && retrieve(frame);
+}
+auto fvkCameraThreadV4L2::latch() -> bool
+{
+	// a latched frame that has not been retrieved goes back to the driver with requeue().
+	m_latched_index = dequeue(m_latched_bytes);
+	return m_latched_index >= 0;
+}
+auto fvkCameraThreadV4L2::retrieve(cv::Mat& frame) -> bool
+{
+	const auto i = m_latched_index;
+	m_latched_index = -1;
+	if (i < 0 || static_cast<std::size_t>(i) >= m_buffers.size())
+		return false;
+
+	auto raw = view(m_buffers[i], m_latched_bytes);
+	m_converted = false;
+
+	// the buffer goes back to the driver when the last copy of the frame header is released.
+	if (!m_convert || m_pixelformat == V4L2_PIX_FMT_GREY || m_pixelformat == V4L2_PIX_FMT_BGR24)
+	{
+		frame = raw;
+		return true;
+	}
+
+	cv::Mat bgr;
+	if (!m_pool.acquire(m_frame_size, CV_8UC3, bgr))
+		bgr.create(m_frame_size, CV_8UC3);
+
+	if (m_pixelformat == V4L2_PIX_FMT_MJPEG)
+		cv::imdecode(raw, cv::IMREAD_COLOR, &bgr);
+	else
+		cv::cvtColor(raw, bgr, m_pixelformat == V4L2_PIX_FMT_YUYV ? cv::COLOR_YUV2BGR_YUYV : cv::COLOR_YUV2BGR_UYVY);
+
+	// the raw frame is not needed anymore, so the buffer is given back at once.
+	raw.release();
+	requeue();
+
+	if (bgr.empty())
+		return false;
+
+	frame = bgr;
+	m_converted = true;
+	return true;
+}
+auto fvkCameraThreadV4L2::skip() -> bool
+{
+	std::uint32_t bytesused = 0;
+	const auto i = dequeue(bytesused);
+	if (i < 0)
+		return false;
+
+	queue(static_cast<std::size_t>(i));
+	return true;
+}
+
+auto fvkCameraThreadV4L2::timestamp() -> double
+{
+	return m_timestamp;
+}
+auto fvkCameraThreadV4L2::isFrameOwned() const -> bool
+{
+	return m_converted;
+}
+
+auto fvkCameraThreadV4L2::setFps(const double fps) -> bool
+{
+	if (m_fd < 0 || fps <= 0)
+		return false;
+
+	v4l2_streamparm parm{};
+	parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (deviceIoctl(m_fd, VIDIOC_G_PARM, &parm) < 0 || !(parm.parm.capture.capability & V4L2_CAP_TIMEPERFRAME))
+		return false;
+
+	parm.parm.capture.timeperframe.numerator = 1000;
+	parm.parm.capture.timeperframe.denominator = static_cast<std::uint32_t>(fps * 1000.0 + 0.5);
+	return deviceIoctl(m_fd, VIDIOC_S_PARM, &parm) == 0;
+}
+auto fvkCameraThreadV4L2::getFps() const -> double
+{
+	if (m_fd < 0)
+		return 0.0;
+
+	v4l2_streamparm parm{};
+	parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	if (const_cast<fvkCameraThreadV4L2*>(this)->deviceIoctl(m_fd, VIDIOC_G_PARM, &parm) < 0 || parm.parm.capture.timeperframe.numerator == 0)
+		return 0.0;
+
+	return static_cast<double>(parm.parm.capture.timeperframe.denominator) / parm.parm.capture.timeperframe.numerator;
+}
+
+/************************************************************************/
+/* Device access                                                        */
+/************************************************************************/
+auto fvkCameraThreadV4L2::deviceOpen(const std::string& path) -> int
+{
+	return ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+}
+void fvkCameraThreadV4L2::deviceClose(const int fd)
+{
+	::close(fd);
+}
+auto fvkCameraThreadV4L2::deviceIoctl(const int fd, const unsigned long request, void* arg) -> int
+{
+	int r;
+	do
+	{
+		r = ::ioctl(fd, request, arg);
+	} while (r == -1 && errno == EINTR);
+	return r;
+}
+auto fvkCameraThreadV4L2::deviceMap(const int fd, const std::size_t length, const long long offset) -> void*
+{
+	const auto p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(offset));
+	return p == MAP_FAILED ? nullptr : p;
+}
+void fvkCameraThreadV4L2::deviceUnmap(void* start, const std::size_t length)
+{
+	::munmap(start, length);
+}
+auto fvkCameraThreadV4L2::deviceWait(const int fd, const int timeout) -> int
+{
+	pollfd p{};
+	p.fd = fd;
+	p.events = POLLIN;
+
+	int r;
+	do
+	{
+		r = ::poll(&p, 1, timeout);
+	} while (r == -1 && errno == EINTR);
+
+	if (r > 0 && (p.revents & (POLLERR | POLLHUP | POLLNVAL)) && !(p.revents & POLLIN))
+		return -1;
+	return r;
+}
+
+#endif // __linux__
@@ -0,0 +1,313 @@
+/*********************************************************************************
+created:	2026/10/18   04:10PM
+filename: 	fvkExecutor.cpp
+file base:	fvkExecutor
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	fixed-size work-stealing thread pool, and a task that runs a fvkThread
+on it one iteration at a time.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkExecutor.h>
+#include <fvk/camera/fvkThread.h>
+
+#include <algorithm>
+#include <climits>
+
+using namespace R3D;
+
+namespace
+{
+	// the executor and the index of the worker that runs on the calling thread.
+	thread_local const fvkExecutor* t_executor = nullptr;
+	thread_local std::size_t t_index = 0;
+
+	auto toNanoseconds(const std::chrono::steady_clock::time_point& time) -> long long
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+	}
+}
+
+fvkExecutor::fvkExecutor(std::size_t nthreads) :
+	m_next(0),
+	m_pending(0),
+	m_idle(0),
+	m_next_timer(LLONG_MAX),
+	m_stop(false)
+{
+	if (nthreads == 0)
+		nthreads = std::max(1u, std::thread::hardware_concurrency());
+
+	for (std::size_t i = 0; i < nthreads; i++)
+		m_workers.emplace_back(new Worker());
+	for (std::size_t i = 0; i < nthreads; i++)
+		m_workers[i]->thread = std::thread([this, i]() { work(i); });
+}
+
+fvkExecutor::~fvkExecutor()
+{
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		m_stop = true;
+	}
+	m_cond.notify_all();
+
+	for (auto& w : m_workers)
+	{
+		if (w->thread.joinable())
+			w->thread.join();
+	}
+}
+
+void fvkExecutor::post(Task task)
+{
+	// a worker keeps its own tasks, the others are spread over all the workers.
+	const auto index = t_executor == this ? t_index : m_next++ % m_workers.size();
+	push(index, std::move(task));
+	wakeOne();
+}
+
+void fvkExecutor::postAt(const TimePoint& time, Task task)
+{
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		m_timers.push(Timer{ time, std::move(task) });
+		m_next_timer = toNanoseconds(m_timers.top().time);
+	}
+	// a sleeping worker has to look at the new earliest deadline.
+	if (m_idle.load() > 0)
+		m_cond.notify_one();
+}
+
+void fvkExecutor::push(const std::size_t index, Task task)
+{
+	{
+		std::lock_guard<std::mutex> lk(m_workers[index]->mutex);
+		m_workers[index]->tasks.push_back(std::move(task));
+	}
+	m_pending++;
+}
+
+void fvkExecutor::wakeOne()
+{
+	// m_pending is increased before m_idle is read, and a worker increases m_idle before
+	// it reads m_pending, so either the worker sees the task or it is notified here.
+	if (m_idle.load() > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+		}
+		m_cond.notify_one();
+	}
+}
+
+auto fvkExecutor::pop(const std::size_t index, Task& task) -> bool
+{
+	auto& w = *m_workers[index];
+	std::lock_guard<std::mutex> lk(w.mutex);
+	if (w.tasks.empty())
+		return false;
+	task = std::move(w.tasks.front());
+	w.tasks.pop_front();
+	m_pending--;
+	return true;
+}
+
+auto fvkExecutor::steal(const std::size_t index, Task& task) -> bool
+{
+	// the oldest task of another worker, it is the one that has waited the longest.
+	const auto n = m_workers.size();
+	for (std::size_t i = 1; i < n; i++)
+	{
+		if (pop((index + i) % n, task))
+			return true;
+	}
+	return false;
+}
+
+auto fvkExecutor::dueTimers(const std::size_t index) -> bool
+{
+	const auto now = std::chrono::steady_clock::now();
+	if (toNanoseconds(now) < m_next_timer.load())
+		return false;
+
+	std::vector<Task> due;
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		while (!m_timers.empty() && m_timers.top().time <= now)
+		{
+			due.push_back(std::move(const_cast<Timer&>(m_timers.top()).task));
+			m_timers.pop();
+		}
+		m_next_timer = m_timers.empty() ? LLONG_MAX : toNanoseconds(m_timers.top().time);
+	}
+
+	for (auto& task : due)
+		push(index, std::move(task));
+	if (due.size() > 1)
+		wakeOne();	// the other due tasks can be stolen.
+	return !due.empty();
+}
+
+void fvkExecutor::work(const std::size_t index)
+{
+	t_executor = this;
+	t_index = index;
+
+	Task task;
+	while (!m_stop)
+	{
+		dueTimers(index);
+
+		if (pop(index, task) || steal(index, task))
+		{
+			task();
+			task = nullptr;
+			continue;
+		}
+
+		// sleep until a task is posted or the earliest timer is due.
+		std::unique_lock<std::mutex> lk(m_mutex);
+		m_idle++;
+		while (!m_stop && m_pending.load() == 0)
+		{
+			if (m_timers.empty())
+			{
+				m_cond.wait(lk);
+			}
+			else
+			{
+				if (m_timers.top().time <= std::chrono::steady_clock::now())
+					break;
+				m_cond.wait_until(lk, m_timers.top().time);
+			}
+		}
+		m_idle--;
+	}
+}
+
+fvkThreadTask::fvkThreadTask(fvkExecutor& executor, fvkThread* thread, std::function<void()> func) :
+	m_executor(executor),
+	p_thread(thread),
+	m_func(std::move(func)),
+	m_state(Waiting),
+	m_kick(false),
+	m_generation(0)
+{
+}
+
+auto fvkThreadTask::start(fvkExecutor& executor, fvkThread* thread, const fvkStopToken& token, std::function<void()> func) -> std::shared_ptr<fvkThreadTask>
+{
+	auto task = std::make_shared<fvkThreadTask>(executor, thread, std::move(func));
+	thread->begin(token);
+
+	// registered after begin(), so the thread is stopped before the task looks at it.
+	// The task counts as queued meanwhile, so a stop that has been requested already
+	// does not post an iteration before the callback is stored.
+	task->m_state = Queued;
+	std::weak_ptr<fvkThreadTask> weak = task;
+	task->m_stopcb.reset(new fvkStopCallback(token, [weak]()
+	{
+		if (const auto t = weak.lock())
+			t->wake();
+	}));
+	task->m_state = Waiting;
+
+	task->wake();
+	return task;
+}
+
+void fvkThreadTask::setPeer(const std::shared_ptr<fvkThreadTask>& peer)
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	m_peer = peer;
+}
+
+void fvkThreadTask::wake()
+{
+	// the flag is set first, so an iteration that is about to finish sees it.
+	m_kick = true;
+	auto expected = static_cast<int>(Waiting);
+	if (m_state.compare_exchange_strong(expected, Queued))
+	{
+		const auto self = shared_from_this();
+		m_executor.post([self]() { self->iterate(); });
+	}
+}
+
+void fvkThreadTask::wait()
+{
+	std::unique_lock<std::mutex> lk(m_mutex);
+	m_cond.wait(lk, [this] { return isFinished(); });
+}
+
+void fvkThreadTask::iterate()
+{
+	m_kick = false;
+
+	// a wake() before the deadline does not make the thread faster than its rate.
+	const auto stopped = !p_thread->active();
+	if (!stopped && std::chrono::steady_clock::now() < p_thread->getDeadline())
+	{
+		schedule(p_thread->getDeadline());
+		return;
+	}
+
+	// a stopped thread is always stepped, so it can leave.
+	const auto run = stopped || p_thread->ready();
+	if (run && !p_thread->step(m_func))
+	{
+		m_stopcb.reset();
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+			m_state = Finished;
+		}
+		m_cond.notify_all();
+		return;
+	}
+
+	if (run)
+	{
+		std::shared_ptr<fvkThreadTask> peer;
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+			peer = m_peer.lock();
+		}
+		if (peer)
+			peer->wake();
+	}
+
+	// a thread that is not ready is looked at again when it is woken up,
+	// or after 10 milliseconds at the latest.
+	schedule(run ? p_thread->getDeadline() : std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+}
+
+void fvkThreadTask::schedule(const std::chrono::steady_clock::time_point& deadline)
+{
+	const auto generation = ++m_generation;
+	m_state = Waiting;
+
+	if (m_kick.load() || deadline <= std::chrono::steady_clock::now())
+	{
+		wake();
+		return;
+	}
+
+	const auto self = shared_from_this();
+	m_executor.postAt(deadline, [self, generation]()
+	{
+		if (self->m_generation.load() == generation)
+			self->wake();
+	});
+}
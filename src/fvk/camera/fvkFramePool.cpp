@@ -0,0 +1,114 @@
+/*********************************************************************************
+created:	2026/10/18   11:05AM
+filename: 	fvkFramePool.cpp
+file base:	fvkFramePool
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	thread-safe pool of pre-sized frame buffers that are recycled instead
+of being allocated for every frame.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkFramePool.h>
+
+using namespace R3D;
+
+fvkFramePool::fvkFramePool(const std::size_t size) :
+	m_frames(size),
+	m_next(0)
+{
+}
+
+void fvkFramePool::setSize(const std::size_t size)
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	m_frames.resize(size);
+	m_next = 0;
+}
+auto fvkFramePool::getSize() const -> std::size_t
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	return m_frames.size();
+}
+
+auto fvkFramePool::acquire(const cv::Size& size, const int type, cv::Mat& frame) -> bool
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+
+	// a free frame that has the requested size and type is taken first, then an unused slot, so the
+	// users of different sizes (for example a zoom and a rotation) do not reallocate each other's frames.
+	const auto n = m_frames.size();
+	auto unused = n;
+	auto other = n;
+	for (std::size_t i = 0; i < n; i++)
+	{
+		const auto k = (m_next + i) % n;
+		auto& m = m_frames[k];
+
+		if (m.empty())
+		{
+			if (unused == n)
+				unused = k;
+			continue;
+		}
+		if (!isFree(m))
+			continue;
+
+		if (m.size() == size && m.type() == type)
+		{
+			frame = m;
+			m_next = k + 1;
+			return true;
+		}
+		if (other == n)
+			other = k;
+	}
+
+	const auto k = unused < n ? unused : other;
+	if (k == n)
+		return false;
+
+	// nobody else refers to this buffer, so it can be (re)allocated safely.
+	auto& m = m_frames[k];
+	m.create(size, type);
+
+	frame = m;
+	m_next = k + 1;
+	return true;
+}
+
+auto fvkFramePool::available() const -> std::size_t
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	std::size_t n = 0;
+	for (const auto& m : m_frames)
+	{
+		if (m.empty() || isFree(m))
+			n++;
+	}
+	return n;
+}
+
+void fvkFramePool::clear()
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	for (auto& m : m_frames)
+		m.release();
+	m_next = 0;
+}
+
+auto fvkFramePool::isFree(const cv::Mat& m) -> bool
+{
+	// reference count is changed atomically by the consumer threads.
+	return m.u && CV_XADD(&m.u->refcount, 0) == 1;
+}
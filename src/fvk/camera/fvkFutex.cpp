@@ -0,0 +1,128 @@
+/*********************************************************************************
+created:	2026/10/18   02:05PM
+filename: 	fvkFutex.cpp
+file base:	fvkFutex
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	parking primitives for the semaphores: a thread can sleep until an atomic
+integer changes its value, and be woken by the thread that changes it.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkFutex.h>
+
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+using namespace R3D;
+
+#if defined(__linux__)
+
+static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex word must be a plain int.");
+
+auto fvkFutex::wait(std::atomic<int>& word, const int expected, const long long nanoseconds) -> bool
+{
+	timespec ts;
+	timespec* pts = nullptr;
+	if (nanoseconds >= 0)
+	{
+		ts.tv_sec = static_cast<time_t>(nanoseconds / 1000000000LL);
+		ts.tv_nsec = static_cast<long>(nanoseconds % 1000000000LL);
+		pts = &ts;
+	}
+
+	// the kernel only parks the thread if word is still equal to expected.
+	const auto r = syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT_PRIVATE, expected, pts, nullptr, 0);
+	return !(r == -1 && errno == ETIMEDOUT);
+}
+
+void fvkFutex::wake(std::atomic<int>& word, const int n)
+{
+	syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE_PRIVATE, n > 0 ? n : INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+// parking lot, the threads that wait on different words can share a slot,
+// so a wake always wakes all the threads of the slot.
+namespace
+{
+struct ParkingSlot
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+};
+auto parkingSlot(const void* address) -> ParkingSlot&
+{
+	static ParkingSlot slots[64];
+	return slots[(reinterpret_cast<std::uintptr_t>(address) >> 4) % 64];
+}
+}
+
+auto fvkFutex::wait(std::atomic<int>& word, const int expected, const long long nanoseconds) -> bool
+{
+	auto& slot = parkingSlot(&word);
+	std::unique_lock<std::mutex> lk(slot.mutex);
+	if (word.load() != expected)
+		return true;
+	if (nanoseconds < 0)
+	{
+		slot.cv.wait(lk);
+		return true;
+	}
+	return slot.cv.wait_for(lk, std::chrono::nanoseconds(nanoseconds)) == std::cv_status::no_timeout;
+}
+
+void fvkFutex::wake(std::atomic<int>& word, const int /*n*/)
+{
+	auto& slot = parkingSlot(&word);
+	std::lock_guard<std::mutex> lk(slot.mutex);
+	slot.cv.notify_all();
+}
+
+#endif
+
+void fvkFutex::pause()
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+auto fvkFutex::spinCount() -> int
+{
+	// a few microseconds, a frame handoff between two running threads takes less than that.
+	// a pause takes from about 10 to 140 cycles depending on the CPU, so 100 pauses are
+	// between 0.5 and 5 microseconds.
+	static const int n = std::thread::hardware_concurrency() > 1 ? 100 : 0;
+	return n;
+}
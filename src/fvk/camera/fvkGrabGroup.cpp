@@ -0,0 +1,156 @@
+/*********************************************************************************
+created:	2026/10/18   10:40PM
+filename: 	fvkGrabGroup.cpp
+file base:	fvkGrabGroup
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	group of camera threads that grab their frames at the same instant.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkGrabGroup.h>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace R3D;
+
+fvkGrabGroup::fvkGrabGroup() :
+	m_members(0),
+	m_arrived(0),
+	m_set(0),
+	m_output_func(nullptr),
+	m_timeout(1000),
+	m_ncomplete(0),
+	m_nincomplete(0),
+	m_skew(0)
+{
+}
+
+void fvkGrabGroup::setFrameSetOutput(const std::function<void(std::vector<fvkFrame>&)> f)
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	m_output_func = std::move(f);
+}
+
+auto fvkGrabGroup::getMembers() const -> std::size_t
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	return m_members;
+}
+
+void fvkGrabGroup::join()
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	m_members++;
+}
+void fvkGrabGroup::leave()
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	if (m_members > 0)
+		m_members--;
+
+	// the others do not wait for a camera that has left.
+	if (m_arrived > 0 && m_arrived >= m_members)
+		release();
+}
+
+auto fvkGrabGroup::arrive(std::uint64_t& set, const std::function<bool()>& cancel) -> bool
+{
+	std::unique_lock<std::mutex> lk(m_mutex);
+	const auto current = m_set;
+	m_arrived++;
+	if (m_arrived >= m_members)
+	{
+		release();
+		set = current;
+		return true;
+	}
+
+	// wait in short slices, so a stop of this camera is seen while it waits.
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_timeout.load());
+	while (m_set == current)
+	{
+		if (cancel && cancel())
+		{
+			m_arrived--;
+			return false;
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		if (now >= deadline)
+		{
+			release();	// the missing cameras are left out of this set.
+			break;
+		}
+
+		m_cv.wait_until(lk, std::min(deadline, now + std::chrono::milliseconds(10)));
+	}
+
+	set = current;
+	return true;
+}
+
+void fvkGrabGroup::release()
+{
+	auto& s = m_sets[m_set];
+	s.members = std::max(m_members, m_arrived);
+	s.expected = m_arrived;
+	s.ndelivered = 0;
+	s.frames.reserve(m_arrived);
+
+	m_arrived = 0;
+	m_set++;
+	m_cv.notify_all();
+}
+
+void fvkGrabGroup::deliver(const std::uint64_t set, fvkFrame frame)
+{
+	std::vector<fvkFrame> frames;
+	std::function<void(std::vector<fvkFrame>&)> output;
+	auto complete = false;
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		const auto it = m_sets.find(set);
+		if (it == m_sets.end())
+			return;
+
+		auto& s = it->second;
+		if (!frame.empty())
+			s.frames.push_back(std::move(frame));
+		if (++s.ndelivered < s.expected)
+			return;
+
+		frames = std::move(s.frames);
+		complete = frames.size() >= s.members;
+		output = m_output_func;
+		m_sets.erase(it);
+	}
+
+	if (complete)
+		m_ncomplete++;
+	else
+		m_nincomplete++;
+
+	if (frames.empty())
+		return;
+
+	std::sort(frames.begin(), frames.end(), [](const fvkFrame& a, const fvkFrame& b) { return a.camera < b.camera; });
+
+	const auto times = std::minmax_element(frames.begin(), frames.end(),
+		[](const fvkFrame& a, const fvkFrame& b) { return a.capture_time < b.capture_time; });
+	m_skew = std::chrono::duration<double, std::milli>(times.second->capture_time - times.first->capture_time).count();
+
+	if (output)
+		output(frames);
+}
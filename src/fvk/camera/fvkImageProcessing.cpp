@@ -812,41 +812,84 @@ void fvkImageProcessing::setEqualizeFilter(cv::Mat& img, double cliplimit, cv::S
 
 void fvkImageProcessing::imageProcessing(cv::Mat& frame)
 {
+	// the settings are copied, so the filters run without the lock and several
+	// threads can process their frames at the same time.
 	m_mutex.lock();
+	const auto zoomperc = m_zoomperc;
+	const auto flip = m_flip;
+	const auto rotangle = m_rotangle;
+	const auto isfacetrack = m_isfacetrack;
+	const auto denoislevel = m_denoislevel;
+	const auto denoismethod = m_denoismethod;
+	const auto smoothness = m_smoothness;
+	const auto equalizelimit = m_equalizelimit;
+	const auto sharplevel = m_sharplevel;
+	const auto details = m_details;
+	const auto pencilsketch = m_pencilsketch;
+	const auto stylization = m_stylization;
+	const auto brigtness = m_brigtness;
+	const auto contrast = m_contrast;
+	const auto colorcontrast = m_colorcontrast;
+	const auto saturation = m_saturation;
+	const auto vibrance = m_vibrance;
+	const auto hue = m_hue;
+	const auto exposure = m_exposure;
+	const auto gamma = m_gamma;
+	const auto sepia = m_sepia;
+	const auto clip = m_clip;
+	const auto isnegative = m_isnegative;
+	const auto isemboss = m_isemboss;
+	const auto ndots = m_ndots;
+	const auto convertcolor = m_convertcolor;
+	const auto isgray = m_isgray;
+	const auto threshold = m_threshold;
+	m_mutex.unlock();
+
+	// the zoom, flip and rotation write their result into a new frame, the frame given
+	// by the caller is shared with the other consumers of the camera and stays untouched.
+	auto owned = false;
 
-	if (m_zoomperc > 0 && m_zoomperc != 100)
+	if (zoomperc > 0 && zoomperc != 100)
 	{
-		auto s = _resizeKeepAspectRatio(frame.cols, frame.rows, static_cast<int>(static_cast<float>(frame.cols * (m_zoomperc / 100.f))), static_cast<int>(static_cast<float>(frame.rows * (m_zoomperc / 100.f))));
-		auto m = cv::Mat(cv::Mat::zeros(s, frame.type()));
+		auto s = _resizeKeepAspectRatio(frame.cols, frame.rows, static_cast<int>(static_cast<float>(frame.cols * (zoomperc / 100.f))), static_cast<int>(static_cast<float>(frame.rows * (zoomperc / 100.f))));
+		cv::Mat m;
+		m_pool.acquire(s, frame.type(), m);		// recycled output frame, if there is a free one.
 		cv::resize(frame, m, s, 0, 0, cv::InterpolationFlags::INTER_CUBIC);
 		frame = m;
+		owned = true;
 	}
 
-	if (m_flip != FlipDirection::None)
+	if (flip != FlipDirection::None)
 	{
 		cv::Mat m;
-		if (m_flip == FlipDirection::Horizontal)
+		m_pool.acquire(frame.size(), frame.type(), m);
+		if (flip == FlipDirection::Horizontal)
 			cv::flip(frame, m, 0);
-		else if (m_flip == FlipDirection::Vertical)
+		else if (flip == FlipDirection::Vertical)
 			cv::flip(frame, m, 1);
-		else if (m_flip == FlipDirection::Both)
+		else if (flip == FlipDirection::Both)
 			cv::flip(frame, m, -1);
 		frame = m;
+		owned = true;
 	}
 
-	if (m_rotangle != 0)
+	if (rotangle != 0)
 	{
 		cv::Mat m;
-		if (m_rotangle == 90.)
+		if (rotangle == 90. || rotangle == 270.)
+			m_pool.acquire(cv::Size(frame.rows, frame.cols), frame.type(), m);
+		else
+			m_pool.acquire(frame.size(), frame.type(), m);
+		if (rotangle == 90.)
 		{
 			cv::transpose(frame, m);
 			cv::flip(m, m, 0);
 		}
-		else if (m_rotangle == 180.)
+		else if (rotangle == 180.)
 		{
 			cv::flip(frame, m, -1);
 		}
-		else if (m_rotangle == 270.)
+		else if (rotangle == 270.)
 		{
 			cv::transpose(frame, m);
 			cv::flip(m, m, 1);
@@ -854,82 +897,100 @@ void fvkImageProcessing::imageProcessing(cv::Mat& frame)
 		else
 		{
 			const auto cen = cv::Point2d(static_cast<double>(frame.cols) / 2.0, static_cast<double>(frame.rows) / 2.0);
-			auto rot_mat = cv::getRotationMatrix2D(cen, m_rotangle, 1.0);
-			const auto bbox = cv::RotatedRect(cen, frame.size(), static_cast<float>(m_rotangle)).boundingRect();
+			auto rot_mat = cv::getRotationMatrix2D(cen, rotangle, 1.0);
+			const auto bbox = cv::RotatedRect(cen, frame.size(), static_cast<float>(rotangle)).boundingRect();
 			rot_mat.at<double>(0, 2) += bbox.width / 2.0 - cen.x;
 			rot_mat.at<double>(1, 2) += bbox.height / 2.0 - cen.y;
 			cv::warpAffine(frame, m, rot_mat, frame.size(), cv::InterpolationFlags::INTER_LINEAR);
 		}
 		frame = m;
+		owned = true;
 	}
 
-	if (m_isfacetrack)
+	// the filters below (and the face rectangle) write into the frame, so they
+	// work on a private copy when the frame is still the shared one.
+	const auto inplace = isfacetrack || denoislevel > 2 || smoothness > 0 || equalizelimit > 0 || sharplevel > 0 ||
+		details > 0 || pencilsketch > 0 || stylization > 0 || brigtness != 0 || contrast != 0 || colorcontrast != 0 ||
+		saturation != 0 || vibrance != 0 || hue != 0 || exposure != 0 || gamma != 0 || sepia > 0 || clip > 0;
+	if (inplace && !owned)
+	{
+		cv::Mat m;
+		m_pool.acquire(frame.size(), frame.type(), m);
+		frame.copyTo(m);
+		frame = m;
+	}
+
+	if (isfacetrack)
+	{
+		std::lock_guard<std::mutex> locker(m_ftmutex);
 		m_ft.detect(frame, 5);
+	}
 
-	if (m_denoislevel > 2)
-		setDenoisingFilter(frame, m_denoislevel, m_denoismethod);
+	if (denoislevel > 2)
+		setDenoisingFilter(frame, denoislevel, denoismethod);
 
-	if (m_smoothness > 0)
+	if (smoothness > 0)
 	{
 		if (frame.channels() == 1 || frame.channels() == 4)
-			setDenoisingFilter(frame, m_smoothness, DenoisingMethod::Gaussian);
+			setDenoisingFilter(frame, smoothness, DenoisingMethod::Gaussian);
 		else
-			setNonPhotorealisticFilter(frame, m_smoothness, 0.1f, fvkImageProcessing::Filters::Smoothing);	// only for 3-channels
+			setNonPhotorealisticFilter(frame, smoothness, 0.1f, fvkImageProcessing::Filters::Smoothing);	// only for 3-channels
 	}
 
-	if (m_equalizelimit > 0)
-		setEqualizeFilter(frame, m_equalizelimit, cv::Size(8, 8));
+	if (equalizelimit > 0)
+		setEqualizeFilter(frame, equalizelimit, cv::Size(8, 8));
 
-	if (m_sharplevel > 0)
-		setWeightedFilter(frame, m_sharplevel, 1.5, -0.5);
+	if (sharplevel > 0)
+		setWeightedFilter(frame, sharplevel, 1.5, -0.5);
 
-	if (m_details > 0)
-		setNonPhotorealisticFilter(frame, m_details, 0.02f, fvkImageProcessing::Filters::Details);
+	if (details > 0)
+		setNonPhotorealisticFilter(frame, details, 0.02f, fvkImageProcessing::Filters::Details);
 
-	if (m_pencilsketch > 0)
-		setNonPhotorealisticFilter(frame, m_pencilsketch, 0.1f, fvkImageProcessing::Filters::PencilSketch);
+	if (pencilsketch > 0)
+		setNonPhotorealisticFilter(frame, pencilsketch, 0.1f, fvkImageProcessing::Filters::PencilSketch);
 
-	if (m_stylization > 0)
-		setNonPhotorealisticFilter(frame, m_stylization, 0.45f, fvkImageProcessing::Filters::Stylization);
+	if (stylization > 0)
+		setNonPhotorealisticFilter(frame, stylization, 0.45f, fvkImageProcessing::Filters::Stylization);
 
-	if (m_brigtness != 0)
-		setBrightnessFilter(frame, m_brigtness);
+	if (brigtness != 0)
+		setBrightnessFilter(frame, brigtness);
 
-	if (m_contrast != 0)
-		setContrastFilter(frame, m_contrast);
+	if (contrast != 0)
+		setContrastFilter(frame, contrast);
 
-	if (m_colorcontrast != 0)
-		setColorContrastFilter(frame, m_colorcontrast);
+	if (colorcontrast != 0)
+		setColorContrastFilter(frame, colorcontrast);
 
-	if (m_saturation != 0)
-		setSaturationFilter(frame, m_saturation);
+	if (saturation != 0)
+		setSaturationFilter(frame, saturation);
 
-	if (m_vibrance != 0)
-		setVibranceFilter(frame, m_vibrance);
+	if (vibrance != 0)
+		setVibranceFilter(frame, vibrance);
 
-	if (m_hue != 0)
-		setHueFilter(frame, m_hue);
+	if (hue != 0)
+		setHueFilter(frame, hue);
 
-	if (m_exposure != 0)
-		setExposureFilter(frame, m_exposure);
+	if (exposure != 0)
+		setExposureFilter(frame, exposure);
 
-	if (m_gamma != 0)
-		setGammaFilter(frame, m_gamma);
+	if (gamma != 0)
+		setGammaFilter(frame, gamma);
 
-	if (m_sepia > 0)
-		setSepiaFilter(frame, m_sepia);
+	if (sepia > 0)
+		setSepiaFilter(frame, sepia);
 
-	if (m_clip > 0)
-		setClipFilter(frame, m_clip);
+	if (clip > 0)
+		setClipFilter(frame, clip);
 
-	if (m_isnegative)
+	if (isnegative)
 	{
 		cv::Mat m;
+		m_pool.acquire(frame.size(), frame.type(), m);
 		cv::bitwise_not(frame, m);
 		frame = m;
 	}
 
-	if (m_isemboss)
+	if (isemboss)
 	{
 		cv::Mat kern = (cv::Mat_<char>(3, 3) <<
 			-1, -1, 0,
@@ -940,7 +1001,7 @@ void fvkImageProcessing::imageProcessing(cv::Mat& frame)
 		frame = m;
 	}
 
-	if (m_ndots > 5)
+	if (ndots > 5)
 	{
 		if (frame.channels() == 4)
 			cv::cvtColor(frame, frame, cv::ColorConversionCodes::COLOR_BGRA2BGR);
@@ -949,7 +1010,7 @@ void fvkImageProcessing::imageProcessing(cv::Mat& frame)
 
 		auto dst = cv::Mat(cv::Mat::zeros(frame.size(), CV_8UC3));
 		auto cir = cv::Mat(cv::Mat::zeros(frame.size(), CV_8UC1));
-		auto bsize = m_ndots;
+		auto bsize = ndots;
 
 		for (auto i = 0; i < frame.rows; i += bsize)
 		{
@@ -980,14 +1041,14 @@ void fvkImageProcessing::imageProcessing(cv::Mat& frame)
 		frame = dst;
 	}
 
-	if (m_convertcolor >= 0)
+	if (convertcolor >= 0)
 	{
 		cv::Mat m;
-		cv::cvtColor(frame, m, m_convertcolor);
+		cv::cvtColor(frame, m, convertcolor);
 		frame = m;
 	}
 
-	if (m_isgray)
+	if (isgray)
 	{
 		cv::Mat m;
 		if (frame.channels() == 3)
@@ -1002,7 +1063,7 @@ void fvkImageProcessing::imageProcessing(cv::Mat& frame)
 		}
 	}
 
-	if (m_threshold > 0)
+	if (threshold > 0)
 	{
 		cv::Mat m;
 		if (frame.channels() == 3)
@@ -1010,16 +1071,17 @@ void fvkImageProcessing::imageProcessing(cv::Mat& frame)
 		else if (frame.channels() == 4)
 			cv::cvtColor(frame, m, cv::ColorConversionCodes::COLOR_BGRA2GRAY);
 		else
-			m = frame;
+			frame.copyTo(m);		// the gray frame may still be the shared one.
 		cv::GaussianBlur(m, m, cv::Size(5, 5), 0, 0);
-		cv::threshold(m, m, 255 - m_threshold, 255, cv::THRESH_BINARY);
+		cv::threshold(m, m, 255 - threshold, 255, cv::THRESH_BINARY);
 		frame = m;
 	}
 
-	if(m_isfacetrack)
+	if (isfacetrack)
+	{
+		std::lock_guard<std::mutex> locker(m_ftmutex);
 		cv::rectangle(frame, m_ft.get().getRect(), cv::Vec3b(166, 154, 75));
-
-	m_mutex.unlock();
+	}
 }
 
 void fvkImageProcessing::setDenoisingMethod(fvkImageProcessing::DenoisingMethod value)
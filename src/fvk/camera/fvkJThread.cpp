@@ -0,0 +1,71 @@
+/*********************************************************************************
+created:	2026/10/18   03:35PM
+filename: 	fvkJThread.cpp
+file base:	fvkJThread
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	owned, joinable thread with a stop token, like std::jthread of C++20.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkJThread.h>
+
+using namespace R3D;
+
+fvkJThread::fvkJThread(std::function<void(const fvkStopToken&)> func) :
+	fvkJThread(fvkStopSource(), std::move(func))
+{
+}
+
+fvkJThread::fvkJThread(const fvkStopSource& source, std::function<void(const fvkStopToken&)> func) :
+	m_source(source),
+	m_thread([f = std::move(func), token = source.get_token()]() { f(token); })
+{
+}
+
+fvkJThread::~fvkJThread()
+{
+	if (joinable())
+	{
+		request_stop();
+		join();
+	}
+}
+
+fvkJThread::fvkJThread(fvkJThread&& other) noexcept :
+	m_source(other.m_source),
+	m_thread(std::move(other.m_thread))
+{
+}
+
+fvkJThread& fvkJThread::operator=(fvkJThread&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (joinable())
+		{
+			request_stop();
+			join();
+		}
+		m_source = other.m_source;
+		m_thread = std::move(other.m_thread);
+	}
+	return *this;
+}
+
+void fvkJThread::join()
+{
+	// a thread can not join itself.
+	if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id())
+		m_thread.join();
+}
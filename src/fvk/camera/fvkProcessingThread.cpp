@@ -25,13 +25,20 @@ camera frame. This thread is synchronized with the camera thread using a semapho
 
 using namespace R3D;
 
-fvkProcessingThread::fvkProcessingThread(const int device_index, fvkCameraAbstract* frameobserver, fvkSemaphoreBuffer<cv::Mat>* buffer) :
-	m_device_index(device_index),
+fvkProcessingThread::fvkProcessingThread(const int device_index, fvkCameraAbstract* frameobserver, fvkSemaphoreBuffer<fvkFrame>* buffer) :
 	p_frameobserver(frameobserver),
 	p_buffer(buffer),
+	m_video_output_func(nullptr),
+	m_device_index(device_index),
 	m_filepath("D:\\saved_snapshot.jpg"),
 	m_save(false),
-	m_video_output_func(nullptr)
+	m_batch_size(1),
+	m_batch_timeout(100),
+	m_nworkers(1),
+	m_pullseq(0),
+	m_nextseq(0),
+	m_nactive(0),
+	m_parallel(false)
 {
 	// this thread is synchronized with the camera thread by semaphore buffer,
 	// which means it is fully dependent on the camera thread, if a frame is
@@ -39,9 +46,10 @@ fvkProcessingThread::fvkProcessingThread(const int device_index, fvkCameraAbstra
 	// otherwise it will keep waiting for the next frame,
 	// so, no need to make a thread delay manually.
 	setDelay(0);
+	setName("fvk-proc-" + std::to_string(device_index));
 }
 
-fvkProcessingThread::fvkProcessingThread(const int device_index, fvkSemaphoreBuffer<cv::Mat>* buffer) : 
+fvkProcessingThread::fvkProcessingThread(const int device_index, fvkSemaphoreBuffer<fvkFrame>* buffer) : 
 	fvkProcessingThread(device_index, nullptr, buffer)
 {
 }
@@ -53,6 +61,10 @@ fvkProcessingThread::~fvkProcessingThread()
 		stop();
 		m_vr.stop();
 	}
+
+	// the workers must leave before the members they use are destroyed.
+	m_workers_stop.request_stop();
+	m_workers.clear();
 }
 
 void fvkProcessingThread::run()
@@ -60,11 +72,65 @@ void fvkProcessingThread::run()
 	if (!p_buffer)
 		return;
 
-	// get a frame from the camera buffer.
+	// with workers, this thread only puts the processed frames back in order.
+	if (m_parallel)
+	{
+		{
+			std::unique_lock<std::mutex> lk(m_ordermutex);
+			m_ordercond.wait_for(lk, std::chrono::milliseconds(m_batch_timeout.load()), [this]
+			{
+				return (!m_reorder.empty() && m_reorder.begin()->first == m_nextseq) || m_nactive == 0;
+			});
+			if (m_reorder.empty() || m_reorder.begin()->first != m_nextseq)
+			{
+				// all the workers have left (the buffer has been closed), there is nothing more to deliver.
+				if (m_nactive == 0)
+					stop();
+				return;
+			}
+			m_batch = std::move(m_reorder.begin()->second);
+			m_reorder.erase(m_reorder.begin());
+			m_nextseq++;
+		}
+		m_ordercond.notify_all();	// a worker may wait for room in the reordering.
+
+		deliver(m_batch);
+		m_batch.clear();
+		return;
+	}
+
+	// batch mode, take all the available frames (up to batch size) at once.
+	const auto n = m_batch_size.load();
+	if (n > 1)
+	{
+		m_batch.clear();
+		if (p_buffer->getBatch(m_batch, n, m_batch_timeout) == 0)
+		{
+			if (p_buffer->isClosed())
+				stop();
+			return;
+		}
+
+		for (auto& frame : m_batch)
+			m_ip.imageProcessing(frame.image);
+
+		deliver(m_batch);
+		m_batch.clear();	// give the frames back to the camera frame pool.
+		return;
+	}
+
+	// get a frame from the camera buffer, it is moved out of the buffer
+	// so the reference count of the frame is not touched.
+	// An empty frame means that the buffer has been closed to stop this thread.
 	auto frame = p_buffer->get();
+	if (frame.empty())
+	{
+		stop();		// it would return at once from now on.
+		return;
+	}
 
 	// do some basic image processing
-	m_ip.imageProcessing(frame);
+	m_ip.imageProcessing(frame.image);
 
 	// send frame to the observer to process it on another class.
 	if (p_frameobserver)
@@ -73,35 +139,198 @@ void fvkProcessingThread::run()
 	// expected to be overridden in the derived class.
 	present(frame);
 
+	output(frame);
+}
+
+void fvkProcessingThread::deliver(std::vector<fvkFrame>& frames)
+{
+	// send frames to the observer to process it on another class.
+	if (p_frameobserver)
+	{
+		for (auto& frame : frames)
+			p_frameobserver->present(frame);
+	}
+
+	// expected to be overridden in the derived class.
+	if (m_batch_size > 1)
+	{
+		presentBatch(frames);
+	}
+	else
+	{
+		for (auto& frame : frames)
+			present(frame);
+	}
+
+	for (auto& frame : frames)
+		output(frame);
+}
+
+void fvkProcessingThread::work(const fvkStopToken& token, const std::size_t nworkers)
+{
+	std::vector<fvkFrame> frames;
+
+	while (!token.stop_requested() && !p_buffer->isClosed())
+	{
+		// a frame that takes long does not let the others pile up behind it.
+		{
+			std::unique_lock<std::mutex> lk(m_ordermutex);
+			if (!m_ordercond.wait_for(lk, std::chrono::milliseconds(m_batch_timeout.load()), [&]
+			{
+				return m_reorder.size() < nworkers || token.stop_requested();
+			}))
+				continue;
+		}
+
+		// the sequence number is taken together with the frames, so it is the order of the buffer.
+		std::uint64_t seq;
+		{
+			std::lock_guard<std::mutex> lk(m_pullmutex);
+			const auto n = m_batch_size.load();
+			if (n > 1)
+			{
+				p_buffer->getBatch(frames, n, m_batch_timeout);
+			}
+			else
+			{
+				fvkFrame frame;
+				if (p_buffer->try_get(frame, m_batch_timeout))
+					frames.push_back(std::move(frame));
+			}
+			if (frames.empty())
+				continue;
+			seq = m_pullseq++;
+		}
+
+		for (auto& frame : frames)
+			m_ip.imageProcessing(frame.image);
+
+		{
+			std::lock_guard<std::mutex> lk(m_ordermutex);
+			m_reorder.emplace(seq, std::move(frames));
+		}
+		m_ordercond.notify_all();
+		frames.clear();
+	}
+
+	{
+		std::lock_guard<std::mutex> lk(m_ordermutex);
+		m_nactive--;
+	}
+	m_ordercond.notify_all();
+}
+
+auto fvkProcessingThread::setWorkerCount(const std::size_t n) -> bool
+{
+	if (n > 1 && p_buffer && p_buffer->getBackend() == fvkBufferBackend::SpscRing)
+	{
+		std::cout << "[" << m_device_index << "] several workers need the Queue backend of the buffer, the ring has only one consumer.\n";
+		return false;
+	}
+
+	m_nworkers = n > 0 ? n : 1;
+	return true;
+}
+
+void fvkProcessingThread::onStart()
+{
+	const auto n = m_nworkers.load();
+	if (n <= 1 || !p_buffer)
+		return;
+
+	// the backend may have been changed after setWorkerCount().
+	if (p_buffer->getBackend() == fvkBufferBackend::SpscRing)
+	{
+		std::cout << "[" << m_device_index << "] the ring buffer has only one consumer, the frames are processed without workers.\n";
+		return;
+	}
+
+	m_pullseq = 0;
+	m_nextseq = 0;
+	m_reorder.clear();
+	m_nactive = n;
+	m_workers_stop = fvkStopSource();
+	m_workers.reserve(n);
+	for (std::size_t i = 0; i < n; i++)
+		m_workers.emplace_back(m_workers_stop, [this, n](const fvkStopToken& token) { work(token, n); });
+	m_parallel = true;
+}
+
+void fvkProcessingThread::onStop()
+{
+	m_parallel = false;
+	m_workers_stop.request_stop();
+	m_ordercond.notify_all();
+	m_workers.clear();		// joins the workers.
+
+	// the frames that have been processed but not delivered are dropped.
+	std::lock_guard<std::mutex> lk(m_ordermutex);
+	m_reorder.clear();
+	m_nactive = 0;
+}
+
+auto fvkProcessingThread::ready() -> bool
+{
+	if (m_parallel)
+	{
+		std::lock_guard<std::mutex> lk(m_ordermutex);
+		return (!m_reorder.empty() && m_reorder.begin()->first == m_nextseq) || m_nactive == 0;
+	}
+	return !p_buffer || p_buffer->isClosed() || !p_buffer->empty();
+}
+
+void fvkProcessingThread::output(fvkFrame& frame)
+{
 	// emit signal to inform to image box for the new frame.
 	if (m_video_output_func)
 		m_video_output_func(frame, m_avgfps.getStats());
 
+	// publish the frame for the display, it never waits for the reader.
+	m_mailbox.publish(frame.image);
+
 	// save current frame to disk.
-	saveFrameToDisk(frame);
+	saveFrameToDisk(frame.image);
 
 	// add frame for the video recording.
 	if (m_vr.isOpened())
-		m_vr.addFrame(frame);
+		m_vr.addFrame(frame.image);
 }
 
-void fvkProcessingThread::setVideoOutput(const std::function<void(cv::Mat&, const fvkThreadStats&)> f)
+void fvkProcessingThread::setVideoOutput(const std::function<void(fvkFrame&, const fvkThreadStats&)> f)
 {
 	m_video_output_func = std::move(f);
 }
+void fvkProcessingThread::setVideoOutput(const std::function<void(cv::Mat&, const fvkThreadStats&)> f)
+{
+	if (!f)
+		m_video_output_func = nullptr;
+	else
+		m_video_output_func = [f](fvkFrame& frame, const fvkThreadStats& stats) { f(frame.image, stats); };
+}
 
 void fvkProcessingThread::present(cv::Mat& _frame)
 {
 	// do nothing!
 }
 
+void fvkProcessingThread::present(fvkFrame& frame)
+{
+	present(frame.image);
+}
+
+void fvkProcessingThread::presentBatch(std::vector<fvkFrame>& frames)
+{
+	for (auto& frame : frames)
+		present(frame);
+}
+
 auto fvkProcessingThread::getFrame() -> cv::Mat
 {
 	const auto f = p_buffer->get();
 	if (f.empty())
 		return cv::Mat();
 
-	return f.clone();
+	return f.image.clone();
 }
 
 void fvkProcessingThread::saveFrameOnClick()
@@ -19,10 +19,14 @@ purpose:	basic semaphore like QSemaphore functionalities.
 **********************************************************************************/
 
 #include <fvk/camera/fvkQSemaphore.h>
+#include <fvk/camera/fvkFutex.h>
 
 using namespace R3D;
 
-fvkQSemaphore::fvkQSemaphore(const int n /*= 0*/) : m_count(n)
+fvkQSemaphore::fvkQSemaphore(const int n /*= 0*/) : 
+	m_count(n),
+	m_waiters(0),
+	m_multi_waiters(0)
 {
 
 }
@@ -34,30 +38,54 @@ fvkQSemaphore::~fvkQSemaphore()
 
 void fvkQSemaphore::release(int n /*= 1*/)
 {
-	std::lock_guard<std::mutex> lk(m_mutex);
-	m_count += n;
-	m_cv.notify_all();
+	m_count.fetch_add(n);
+	if (m_waiters.load() > 0)
+	{
+		// every parked thread needs at least one count, so at most n of them can proceed.
+		// If a thread needs more than one count, the released counts may not be enough
+		// for the woken threads but enough for the others, so all of them are woken.
+		fvkFutex::wake(m_count, m_multi_waiters.load() > 0 ? 0 : n);
+	}
 }
 
 void fvkQSemaphore::acquire(int n /*= 1*/)
 {
-	std::unique_lock<std::mutex> lk(m_mutex);
-	while (n > m_count)
-		m_cv.wait(lk);
-	m_count -= n;
+	if (tryAcquire(n))
+		return;
+	if (fvkFutex::spin([this, n] { return tryAcquire(n); }))
+		return;
+
+	// the waiters are counted before the count is checked again, and release() changes
+	// the count before it checks the waiters, so this thread is never left parked.
+	m_waiters.fetch_add(1);
+	if (n > 1) m_multi_waiters.fetch_add(1);
+	while (true)
+	{
+		auto c = m_count.load();
+		if (c >= n)
+		{
+			if (m_count.compare_exchange_weak(c, c - n))
+				break;
+			continue;
+		}
+		fvkFutex::wait(m_count, c);
+	}
+	if (n > 1) m_multi_waiters.fetch_sub(1);
+	m_waiters.fetch_sub(1);
 }
 
 auto fvkQSemaphore::tryAcquire(int n /*= 1*/) -> bool
 {
-	std::lock_guard<std::mutex> lk(m_mutex);
-	if (n > m_count) return false;
-	m_count -= n;
-	return true;
+	auto c = m_count.load();
+	while (c >= n)
+	{
+		if (m_count.compare_exchange_weak(c, c - n))
+			return true;
+	}
+	return false;
 }
 
 auto fvkQSemaphore::count() -> int
 {
-	std::lock_guard<std::mutex> lk(m_mutex);
-	return m_count;
+	return m_count.load();
 }
-
@@ -0,0 +1,185 @@
+/*********************************************************************************
+created:	2026/10/18   07:05PM
+filename: 	fvkScheduler.cpp
+file base:	fvkScheduler
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	single-thread scheduler of periodic tasks for the auxiliary jobs.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkScheduler.h>
+
+using namespace R3D;
+
+fvkScheduler::fvkScheduler() :
+	m_running(0),
+	m_next_id(1),
+	m_thread([this](const fvkStopToken& token) { work(token); })
+{
+}
+
+fvkScheduler::~fvkScheduler()
+{
+	m_thread.request_stop();
+	m_thread.join();
+}
+
+auto fvkScheduler::schedule(const Duration& period, Task task) -> std::size_t
+{
+	return add(std::chrono::steady_clock::now() + period, period, std::move(task));
+}
+auto fvkScheduler::schedule(const TimePoint& first, const Duration& period, Task task) -> std::size_t
+{
+	return add(first, period, std::move(task));
+}
+auto fvkScheduler::scheduleOnce(const Duration& delay, Task task) -> std::size_t
+{
+	return add(std::chrono::steady_clock::now() + delay, Duration::zero(), std::move(task));
+}
+
+auto fvkScheduler::add(const TimePoint& first, const Duration& period, Task task) -> std::size_t
+{
+	auto job = std::make_shared<Job>();
+	job->task = std::move(task);
+	job->period = period > Duration::zero() ? period : Duration::zero();
+	job->deadline = first;
+
+	std::size_t id;
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		id = m_next_id++;
+		m_jobs.emplace(id, job);
+		m_queue.push(Entry{ first, id });
+	}
+	m_cond.notify_one();	// the new task may be the earliest one.
+	return id;
+}
+
+auto fvkScheduler::cancel(const std::size_t id) -> bool
+{
+	// the entry of the task stays in the queue, it is discarded when it is due.
+	std::unique_lock<std::mutex> lk(m_mutex);
+	if (m_jobs.erase(id) == 0)
+		return false;
+
+	if (std::this_thread::get_id() != m_thread.get_id())
+		m_donecond.wait(lk, [this, id] { return m_running != id; });
+	return true;
+}
+
+auto fvkScheduler::setPeriod(const std::size_t id, const Duration& period) -> bool
+{
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		const auto it = m_jobs.find(id);
+		if (it == m_jobs.end())
+			return false;
+
+		// the old entry does not match the new deadline anymore, so it is discarded when it is due.
+		auto& job = *it->second;
+		const auto last = job.deadline - job.period;
+		job.period = period > Duration::zero() ? period : Duration::zero();
+		job.deadline = last + job.period;
+		m_queue.push(Entry{ job.deadline, id });
+	}
+	m_cond.notify_one();
+	return true;
+}
+
+auto fvkScheduler::getStats(const std::size_t id) const -> fvkTaskStats
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	const auto it = m_jobs.find(id);
+	return it != m_jobs.end() ? it->second->stats : fvkTaskStats();
+}
+
+auto fvkScheduler::size() const -> std::size_t
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	return m_jobs.size();
+}
+
+void fvkScheduler::work(const fvkStopToken& token)
+{
+	// the callback takes the mutex, so the stop can not be requested between the check and the wait.
+	fvkStopCallback wake(token, [this]()
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		m_cond.notify_all();
+	});
+
+	std::unique_lock<std::mutex> lk(m_mutex);
+	while (!token.stop_requested())
+	{
+		if (m_queue.empty())
+		{
+			m_cond.wait(lk);
+			continue;
+		}
+
+		const auto entry = m_queue.top();
+		if (entry.time > std::chrono::steady_clock::now())
+		{
+			m_cond.wait_until(lk, entry.time);
+			continue;
+		}
+		m_queue.pop();
+
+		// a cancelled task, or an entry that has been replaced by setPeriod().
+		auto it = m_jobs.find(entry.id);
+		if (it == m_jobs.end() || it->second->deadline != entry.time)
+			continue;
+		const auto job = it->second;
+
+		// the task runs without the lock, so it can schedule or cancel tasks (even itself).
+		m_running = entry.id;
+		lk.unlock();
+		const auto start = std::chrono::steady_clock::now();
+		job->task();
+		lk.lock();
+		m_running = 0;
+		m_donecond.notify_all();
+
+		auto& s = job->stats;
+		const auto jitter = std::chrono::duration_cast<std::chrono::microseconds>(start - entry.time).count();
+		s.nruns++;
+		s.mean_jitter += (static_cast<double>(jitter) - s.mean_jitter) / static_cast<double>(s.nruns);
+		if (jitter > s.max_jitter)
+			s.max_jitter = jitter;
+		s.jitter[fvkBufferStats::bucket(jitter * 1000)]++;
+
+		// cancelled or rescheduled while it was running.
+		it = m_jobs.find(entry.id);
+		if (it == m_jobs.end() || it->second != job || job->deadline != entry.time)
+			continue;
+
+		if (job->period == Duration::zero())
+		{
+			m_jobs.erase(it);
+			continue;
+		}
+
+		// the next deadline stays on the grid, the periods that are over already are skipped.
+		auto next = entry.time + job->period;
+		const auto now = std::chrono::steady_clock::now();
+		if (next < now)
+		{
+			const auto missed = (now - next) / job->period + 1;
+			next += missed * job->period;
+			s.nmissed += static_cast<std::uint64_t>(missed);
+		}
+		job->deadline = next;
+		m_queue.push(Entry{ next, entry.id });
+	}
+}
@@ -19,57 +19,147 @@ purpose:	class for a basic semaphore like functionalities.
 **********************************************************************************/
 
 #include <fvk/camera/fvkSemaphore.h>
+#include <fvk/camera/fvkFutex.h>
+
+#include <chrono>
 
 using namespace R3D;
 
-fvkSemaphore::fvkSemaphore(const int count) : m_count{ count }
+// nanoseconds since the steady clock epoch.
+static auto steadyNow() -> long long
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+fvkSemaphore::fvkSemaphore(const int count) : 
+	m_count{ count },
+	m_waiters{ 0 },
+	m_closed{ false }
 {
 }
 
-void fvkSemaphore::wait()
+auto fvkSemaphore::wait() -> bool
 {
-	std::unique_lock<std::mutex> lock{ m_mutex };
-	m_cv.wait(lock, [&]{ return m_count > 0; });
-	--m_count;
+	if (try_wait())
+		return true;
+	// the notify usually comes in a moment, do not pay for parking the thread.
+	if (fvkFutex::spin([this] { return try_wait() || m_closed.load(); }))
+		return !m_closed.load();
+	return park(-1);
 }
 
 auto fvkSemaphore::try_wait() -> bool
 {
-	std::lock_guard<std::mutex> lock{ m_mutex };
-	if (m_count > 0)
+	if (m_closed.load())
+		return false;
+	auto n = m_count.load();
+	while (n > 0)
 	{
-		--m_count;
-		return true;
+		if (m_count.compare_exchange_weak(n, n - 1))
+			return true;
 	}
 	return false;
 }
 
 void fvkSemaphore::notify()
 {
-	std::lock_guard<std::mutex> lock{ m_mutex };
-	++m_count;
-	m_cv.notify_one();
+	m_count.fetch_add(1);
+	if (m_waiters.load() > 0)
+		fvkFutex::wake(m_count, 1);		// wake only one parked thread.
+}
+
+auto fvkSemaphore::try_wait_many(const int max) -> int
+{
+	if (m_closed.load())
+		return 0;
+	auto n = m_count.load();
+	while (n > 0)
+	{
+		const auto k = n < max ? n : max;
+		if (k <= 0)
+			return 0;
+		if (m_count.compare_exchange_weak(n, n - k))
+			return k;
+	}
+	return 0;
+}
+
+void fvkSemaphore::notify(const int count)
+{
+	if (count <= 0)
+		return;
+	m_count.fetch_add(count);
+	if (m_waiters.load() > 0)
+		fvkFutex::wake(m_count, count);
 }
 
 auto fvkSemaphore::wait_for(const unsigned long milliseconds) -> bool
 {
-	std::unique_lock<std::mutex> lock{ m_mutex };
-	auto finished = m_cv.wait_for(lock, std::chrono::milliseconds(milliseconds), [&] { return m_count > 0; });
-	if (finished)
-		--m_count;
-	return finished;
+	if (try_wait())
+		return true;
+	if (milliseconds == 0)
+		return false;
+	const auto deadline = steadyNow() + static_cast<long long>(milliseconds) * 1000000LL;
+	if (fvkFutex::spin([this] { return try_wait() || m_closed.load(); }))
+		return !m_closed.load();
+	return park(deadline);
+}
+
+void fvkSemaphore::close()
+{
+	m_closed.store(true);
+	// change the count, so a thread that is about to be parked sees the change.
+	m_count.fetch_add(1);
+	fvkFutex::wake(m_count, 0);
+}
+
+auto fvkSemaphore::isClosed() const -> bool
+{
+	return m_closed.load();
+}
+
+void fvkSemaphore::reset(const int count)
+{
+	m_count.store(count);
+	m_closed.store(false);
 }
 
 auto fvkSemaphore::wait_until(const unsigned long milliseconds) -> bool
 {
-	std::unique_lock<std::mutex> lock{ m_mutex };
-	auto finished = m_cv.wait_until(lock, std::chrono::system_clock::now() + std::chrono::milliseconds(milliseconds), [&] { return m_count > 0; });
-	if (finished)
-		--m_count;
-	return finished;
+	return wait_for(milliseconds);
 }
 
 auto fvkSemaphore::native_handle() ->std::condition_variable::native_handle_type
 {
 	return m_cv.native_handle();
-}
\ No newline at end of file
+}
+
+auto fvkSemaphore::park(const long long deadline) -> bool
+{
+	// the waiters are counted before the count is checked again, and notify() changes
+	// the count before it checks the waiters, so either this thread sees the new count,
+	// or notify() sees this thread and wakes it.
+	m_waiters.fetch_add(1);
+	auto ok = true;
+	while (!try_wait())
+	{
+		if (m_closed.load())
+		{
+			ok = false;
+			break;
+		}
+		auto timeout = -1LL;
+		if (deadline >= 0)
+		{
+			timeout = deadline - steadyNow();
+			if (timeout <= 0)
+			{
+				ok = false;
+				break;
+			}
+		}
+		fvkFutex::wait(m_count, 0, timeout);
+	}
+	m_waiters.fetch_sub(1);
+	return ok;
+}
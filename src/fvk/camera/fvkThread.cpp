@@ -50,15 +50,49 @@ std::thread th(std::ref(task), any_function);
 **********************************************************************************/
 
 #include <fvk/camera/fvkThread.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <thread>
 
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX				// std::max() and std::min() are used in this file.
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace R3D;
 
 fvkThread::fvkThread() :
+	m_statsseq(0),
+	m_nfps(0),
+	m_nframes(0),
+	m_pending_frame(INT_MIN),
 	m_isstop(false),
+	m_isrunning(false),
 	m_ispause(false),
-	m_delay(1000 / 33)	// delay between frames (30 fps).
+	m_delay(1000000000LL / 30),	// delay between frames (30 fps).
+	m_pacing(fvkPacing::CatchUp),
+	m_overruns(0),
+	m_heartbeat(0),
+	m_period(0),
+	m_schedpolicy(fvkSchedPolicy::Other),
+	m_schedpriority(0),
+	m_attrset(0),
+	m_attrchanged(false)
 {
 }
 
@@ -74,50 +108,177 @@ void fvkThread::run()
 
 void fvkThread::start(const std::function<void()> func)
 {
-	// make stats to zero for the new run.
-	m_avgfps.getStats().nfps = 0;
-	m_avgfps.getStats().nframes = 0;
-	m_isstop = false;
+	start(fvkStopToken(), func);
+}
+
+void fvkThread::start(const fvkStopToken& token, const std::function<void()> func)
+{
+	begin(token);
+	applyAttributes();
 
 	// start the main thread.
 	while (true)
 	{
-		// stop this thread.
-		if (m_isstop)
+		if (m_attrchanged)
+			applyAttributes();
+
+		// pause this thread.
 		{
-			m_isstop = false;
-			break;
+			std::unique_lock<std::mutex> lk(m_pausemutex);
+			if (m_ispause)
+			{
+				m_pausecond.wait(lk, [this] { return !m_ispause || m_isstop; });
+				m_deadline = std::chrono::steady_clock::now();	// the pause is not an overrun.
+			}
 		}
 
-		// pause this thread.
-		while (m_ispause)
+		if (!step(func))
+			break;
+
+		// sleep until the deadline, but wake up on stop().
+		if (m_deadline > std::chrono::steady_clock::now())
 		{
 			std::unique_lock<std::mutex> lk(m_pausemutex);
-			m_pausecond.wait(lk);
-			lk.unlock();
+			m_pausecond.wait_until(lk, m_deadline, [this] { return m_isstop.load(); });
 		}
+	}
+}
+
+void fvkThread::begin(const fvkStopToken& token)
+{
+	// make stats to zero for the new run.
+	m_avgfps.getStats().nfps = 0;
+	m_avgfps.getStats().nframes = 0;
+	m_pending_frame = INT_MIN;
+	publishStats();
+	m_isstop = false;
+	m_overruns = 0;
+
+	// registered after m_isstop is reset, it calls stop() right away if the stop has been requested.
+	m_stopcb.reset(new fvkStopCallback(token, [this]() { stop(); }));
+	onStart();
+	setRunning(true);
 
-		if (func)
-			func();
-		else
-			run();	// function to be overridden
+	// the deadline of the next iteration.
+	m_deadline = std::chrono::steady_clock::now();
+	beat(m_deadline);
+}
+
+auto fvkThread::step(const std::function<void()> func) -> bool
+{
+	// stop this thread.
+	if (m_isstop)
+	{
+		m_isstop = false;
+		m_stopcb.reset();	// no more stop() from the token once this thread has left.
+		onStop();
+		setRunning(false);
+		return false;
+	}
 
-		// update stats.
-		m_statsmutex.lock();
-		m_avgfps.update();
-		sleep(m_delay);
-		m_statsmutex.unlock();
+	// a paused thread that is stepped by an executor is looked at again after the delay.
+	if (pause())
+	{
+		const auto now = std::chrono::steady_clock::now();
+		beat(now);
+		m_deadline = now + std::max(std::chrono::nanoseconds(m_delay.load()), std::chrono::nanoseconds(std::chrono::milliseconds(10)));
+		return true;
+	}
+
+	if (func)
+		func();
+	else
+		run();	// function to be overridden
+
+	// update stats.
+	const auto frame = m_pending_frame.exchange(INT_MIN);
+	if (frame != INT_MIN)
+		m_avgfps.getStats().nframes = frame;
+	m_avgfps.update();
+	publishStats();
+	beat(std::chrono::steady_clock::now());
+
+	advance(m_deadline);
+	return true;
+}
+
+void fvkThread::beat(const std::chrono::steady_clock::time_point& time)
+{
+	m_heartbeat.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+}
+auto fvkThread::getHeartbeat() const -> std::chrono::steady_clock::time_point
+{
+	return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(m_heartbeat.load(std::memory_order_relaxed)));
+}
+auto fvkThread::getHeartbeatPeriod() const -> std::chrono::nanoseconds
+{
+	return std::chrono::nanoseconds(m_period.load(std::memory_order_relaxed));
+}
+
+void fvkThread::advance(std::chrono::steady_clock::time_point& deadline)
+{
+	const auto delay = std::chrono::nanoseconds(getIterationDelay());
+	const auto now = std::chrono::steady_clock::now();
+	m_period.store(delay.count(), std::memory_order_relaxed);
+	if (delay.count() <= 0)
+	{
+		deadline = now;
+		return;
+	}
+
+	if (m_pacing == fvkPacing::Relative)
+	{
+		deadline = now + delay;
+	}
+	else
+	{
+		deadline += delay;
+		if (deadline < now)
+		{
+			m_overruns++;
+			if (m_pacing == fvkPacing::Skip)
+				deadline += ((now - deadline) / delay + 1) * delay;	// next deadline on the grid.
+			else if (now - deadline > delay)
+				deadline = now - delay;		// do not make up for more than one delay.
+		}
 	}
 }
 
 void fvkThread::stop()
 {
-	m_isstop = true;
+	{
+		std::lock_guard<std::mutex> lk(m_pausemutex);
+		m_isstop = true;
+	}
+	m_pausecond.notify_one();	// wake up the paused thread.
 }
 auto fvkThread::active() const -> bool
 {
 	return !m_isstop;
 }
+auto fvkThread::isRunning() const -> bool
+{
+	std::lock_guard<std::mutex> lk(m_runningmutex);
+	return m_isrunning;
+}
+auto fvkThread::waitForStarted(const unsigned long milliseconds) -> bool
+{
+	std::unique_lock<std::mutex> lk(m_runningmutex);
+	return m_runningcond.wait_for(lk, std::chrono::milliseconds(milliseconds), [this] { return m_isrunning; });
+}
+auto fvkThread::waitForFinished(const unsigned long milliseconds) -> bool
+{
+	std::unique_lock<std::mutex> lk(m_runningmutex);
+	return m_runningcond.wait_for(lk, std::chrono::milliseconds(milliseconds), [this] { return !m_isrunning; });
+}
+void fvkThread::setRunning(const bool b)
+{
+	{
+		std::lock_guard<std::mutex> lk(m_runningmutex);
+		m_isrunning = b;
+	}
+	m_runningcond.notify_all();
+}
 
 void fvkThread::pause(const bool b)
 {
@@ -133,31 +294,213 @@ auto fvkThread::pause() -> bool
 	return m_ispause;
 }
 
-auto fvkThread::getAvgFps() -> int
+auto fvkThread::getAvgFps() const -> int
 {
-	std::lock_guard<std::mutex> lk(m_statsmutex);
-	return m_avgfps.getStats().nfps;
+	return m_nfps.load(std::memory_order_relaxed);
 }
 void fvkThread::setFrameNumber(const int frame)
 {
-	std::lock_guard<std::mutex> lk(m_statsmutex);
-	m_avgfps.getStats().nframes = frame;
+	m_pending_frame = frame;
+	m_nframes.store(frame, std::memory_order_relaxed);	// so the caller reads it back right away.
+}
+auto fvkThread::getFrameNumber() const -> int
+{
+	return m_nframes.load(std::memory_order_relaxed);
+}
+auto fvkThread::getStats() const -> fvkThreadStats
+{
+	fvkThreadStats s;
+	while (true)
+	{
+		const auto seq = m_statsseq.load(std::memory_order_acquire);
+		if (seq & 1)
+		{
+			std::this_thread::yield();	// the thread is publishing right now.
+			continue;
+		}
+		s.nfps = m_nfps.load(std::memory_order_relaxed);
+		s.nframes = m_nframes.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (m_statsseq.load(std::memory_order_relaxed) == seq)
+			return s;
+	}
 }
-auto fvkThread::getFrameNumber() -> int
+void fvkThread::publishStats()
 {
-	std::lock_guard<std::mutex> lk(m_statsmutex);
-	return m_avgfps.getStats().nframes;
+	const auto seq = m_statsseq.load(std::memory_order_relaxed);
+	m_statsseq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	m_nfps.store(m_avgfps.getStats().nfps, std::memory_order_relaxed);
+	m_nframes.store(m_avgfps.getStats().nframes, std::memory_order_relaxed);
+	m_statsseq.store(seq + 2, std::memory_order_release);
 }
 
 void fvkThread::setDelay(const int delay_msec)
 {
-	std::lock_guard<std::mutex> lk(m_statsmutex);
-	m_delay = delay_msec;
+	m_delay = static_cast<long long>(delay_msec) * 1000000LL;
 }
 auto fvkThread::getDelay() -> int
 {
-	std::lock_guard<std::mutex> lk(m_statsmutex);
-	return m_delay;
+	return static_cast<int>((m_delay.load() + 500000LL) / 1000000LL);
+}
+void fvkThread::setFrameRate(const double fps)
+{
+	m_delay = fps > 0 ? static_cast<long long>(1e9 / fps + 0.5) : 0;
+}
+auto fvkThread::getFrameRate() const -> double
+{
+	const auto delay = m_delay.load();
+	return delay > 0 ? 1e9 / static_cast<double>(delay) : 0.0;
+}
+
+void fvkThread::setAffinity(const std::vector<int>& cpus)
+{
+	std::lock_guard<std::mutex> lk(m_attrmutex);
+	m_affinity = cpus;
+	m_attrset |= AttrAffinity;
+	m_attrchanged = true;
+}
+auto fvkThread::getAffinity() const -> std::vector<int>
+{
+	std::lock_guard<std::mutex> lk(m_attrmutex);
+	return m_affinity;
+}
+void fvkThread::setScheduling(const fvkSchedPolicy policy, const int priority)
+{
+	std::lock_guard<std::mutex> lk(m_attrmutex);
+	m_schedpolicy = policy;
+	m_schedpriority = priority;
+	m_attrset |= AttrScheduling;
+	m_attrchanged = true;
+}
+auto fvkThread::getSchedPolicy() const -> fvkSchedPolicy
+{
+	std::lock_guard<std::mutex> lk(m_attrmutex);
+	return m_schedpolicy;
+}
+auto fvkThread::getSchedPriority() const -> int
+{
+	std::lock_guard<std::mutex> lk(m_attrmutex);
+	return m_schedpriority;
+}
+void fvkThread::setName(const std::string& name)
+{
+	std::lock_guard<std::mutex> lk(m_attrmutex);
+	m_name = name;
+	m_attrset |= AttrName;
+	m_attrchanged = true;
+}
+auto fvkThread::getName() const -> std::string
+{
+	std::lock_guard<std::mutex> lk(m_attrmutex);
+	return m_name;
+}
+
+void fvkThread::applyAttributes()
+{
+	m_attrchanged = false;
+
+	std::vector<int> affinity;
+	fvkSchedPolicy policy;
+	int priority;
+	std::string name;
+	int set;
+	{
+		std::lock_guard<std::mutex> lk(m_attrmutex);
+		set = m_attrset;
+		affinity = m_affinity;
+		policy = m_schedpolicy;
+		priority = m_schedpriority;
+		name = m_name;
+	}
+
+#if defined(__linux__)
+	const auto self = pthread_self();
+
+	// affinity, an empty list allows the cores of the process.
+	if (set & AttrAffinity)
+	{
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		if (affinity.empty())
+			sched_getaffinity(getpid(), sizeof(cpus), &cpus);
+		for (const auto cpu : affinity)
+		{
+			if (cpu >= 0 && cpu < CPU_SETSIZE)
+				CPU_SET(cpu, &cpus);
+		}
+		const auto err = pthread_setaffinity_np(self, sizeof(cpus), &cpus);
+		if (err != 0)
+			std::cout << "[" << name << "] could not set the thread affinity: " << std::strerror(err) << "\n";
+	}
+
+	// scheduling policy, the nice value belongs to the thread (its kernel task) on Linux.
+	if (set & AttrScheduling)
+	{
+		sched_param param;
+		std::memset(&param, 0, sizeof(param));
+		auto p = SCHED_OTHER;
+		if (policy != fvkSchedPolicy::Other)
+		{
+			p = policy == fvkSchedPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+			param.sched_priority = std::min(std::max(priority, sched_get_priority_min(p)), sched_get_priority_max(p));
+		}
+		const auto err = pthread_setschedparam(self, p, &param);
+		if (err != 0)
+			std::cout << "[" << name << "] could not set the thread scheduling policy: " << std::strerror(err) << "\n";
+		if (policy == fvkSchedPolicy::Other && setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), priority) != 0)
+			std::cout << "[" << name << "] could not set the thread nice value: " << std::strerror(errno) << "\n";
+	}
+
+	// name, the kernel keeps 15 characters.
+	if ((set & AttrName) && !name.empty())
+		pthread_setname_np(self, name.substr(0, 15).c_str());
+
+#elif defined(_WIN32)
+	const auto self = GetCurrentThread();
+
+	if (set & AttrAffinity)
+	{
+		DWORD_PTR mask = 0;
+		for (const auto cpu : affinity)
+		{
+			if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8))
+				mask |= static_cast<DWORD_PTR>(1) << cpu;
+		}
+		if (mask == 0)
+		{
+			DWORD_PTR system_mask = 0;
+			GetProcessAffinityMask(GetCurrentProcess(), &mask, &system_mask);
+		}
+		if (SetThreadAffinityMask(self, mask) == 0)
+			std::cout << "[" << name << "] could not set the thread affinity.\n";
+	}
+
+	// the real-time policies map to the highest priorities, a nice value to the normal ones.
+	if (set & AttrScheduling)
+	{
+		auto p = THREAD_PRIORITY_NORMAL;
+		if (policy != fvkSchedPolicy::Other)
+			p = priority >= 50 ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+		else if (priority <= -10)
+			p = THREAD_PRIORITY_HIGHEST;
+		else if (priority < 0)
+			p = THREAD_PRIORITY_ABOVE_NORMAL;
+		else if (priority >= 10)
+			p = THREAD_PRIORITY_LOWEST;
+		else if (priority > 0)
+			p = THREAD_PRIORITY_BELOW_NORMAL;
+		if (!SetThreadPriority(self, p))
+			std::cout << "[" << name << "] could not set the thread priority.\n";
+	}
+
+	if ((set & AttrName) && !name.empty())
+		SetThreadDescription(self, std::wstring(name.begin(), name.end()).c_str());
+#else
+	(void)set;
+	(void)policy;
+	(void)priority;
+#endif
 }
 
 void fvkThread::sleep(const unsigned long milliseconds)
@@ -166,5 +509,9 @@ void fvkThread::sleep(const unsigned long milliseconds)
 }
 void fvkThread::sleep_until(const unsigned long milliseconds)
 {
-	std::this_thread::sleep_until(std::chrono::system_clock::now() + std::chrono::milliseconds(milliseconds));
+	std::this_thread::sleep_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds));
+}
+void fvkThread::sleep_until(const std::chrono::steady_clock::time_point& time)
+{
+	std::this_thread::sleep_until(time);
 }
\ No newline at end of file
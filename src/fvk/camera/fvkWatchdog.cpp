@@ -0,0 +1,155 @@
+/*********************************************************************************
+created:	2026/10/18   07:50PM
+filename: 	fvkWatchdog.cpp
+file base:	fvkWatchdog
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	watchdog that finds the stalled camera and processing threads.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkWatchdog.h>
+#include <fvk/camera/fvkThread.h>
+
+#include <algorithm>
+#include <utility>
+
+using namespace R3D;
+
+fvkWatchdog::fvkWatchdog(const std::chrono::milliseconds& period) :
+	m_own(new fvkScheduler()),
+	m_scheduler(*m_own),
+	m_task(0)
+{
+	m_task = m_scheduler.schedule(period, [this]() { check(); });
+}
+
+fvkWatchdog::fvkWatchdog(fvkScheduler& scheduler, const std::chrono::milliseconds& period) :
+	m_scheduler(scheduler),
+	m_task(0)
+{
+	m_task = m_scheduler.schedule(period, [this]() { check(); });
+}
+
+fvkWatchdog::~fvkWatchdog()
+{
+	// waits for a check that is being executed.
+	m_scheduler.cancel(m_task);
+}
+
+void fvkWatchdog::watch(fvkThread* thread, const std::chrono::milliseconds& timeout, fvkStallFunc f)
+{
+	if (!thread)
+		return;
+
+	std::lock_guard<std::mutex> lk(m_mutex);
+	const auto it = find(thread);
+	if (it != m_watches.end())
+	{
+		it->timeout = timeout;
+		it->func = std::move(f);
+		return;
+	}
+
+	Watch w;
+	w.thread = thread;
+	w.timeout = timeout;
+	w.func = std::move(f);
+	w.beat = thread->getHeartbeat();
+	w.since = std::chrono::steady_clock::now();
+	w.stalled = false;
+	w.nstalls = 0;
+	m_watches.push_back(std::move(w));
+}
+
+auto fvkWatchdog::unwatch(fvkThread* thread) -> bool
+{
+	// a check that is calling the functions is finished first.
+	std::lock_guard<std::recursive_mutex> ck(m_checkmutex);
+	std::lock_guard<std::mutex> lk(m_mutex);
+	const auto it = find(thread);
+	if (it == m_watches.end())
+		return false;
+	m_watches.erase(it);
+	return true;
+}
+
+auto fvkWatchdog::isStalled(fvkThread* thread) const -> bool
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	const auto it = find(thread);
+	return it != m_watches.end() && it->stalled;
+}
+
+auto fvkWatchdog::getStallCount(fvkThread* thread) const -> int
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	const auto it = find(thread);
+	return it != m_watches.end() ? it->nstalls : 0;
+}
+
+auto fvkWatchdog::find(fvkThread* thread) const -> std::vector<Watch>::const_iterator
+{
+	return std::find_if(m_watches.begin(), m_watches.end(), [thread](const Watch& w) { return w.thread == thread; });
+}
+auto fvkWatchdog::find(fvkThread* thread) -> std::vector<Watch>::iterator
+{
+	return std::find_if(m_watches.begin(), m_watches.end(), [thread](const Watch& w) { return w.thread == thread; });
+}
+
+void fvkWatchdog::check()
+{
+	std::lock_guard<std::recursive_mutex> ck(m_checkmutex);
+
+	// the functions are called without the lock, so they can watch or unwatch threads.
+	std::vector<std::pair<fvkStallFunc, std::pair<fvkThread*, bool>>> calls;
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		const auto now = std::chrono::steady_clock::now();
+		for (auto& w : m_watches)
+		{
+			const auto t = w.thread;
+			const auto beat = t->getHeartbeat();
+			const auto progress = beat != w.beat;
+			w.beat = beat;
+
+			// a thread that does not run, is paused or waits for another thread is not stalled.
+			const auto waiting = !t->isRunning() || t->pause() || !t->ready();
+			if (progress || waiting)
+			{
+				w.since = now;
+				if (w.stalled)
+				{
+					w.stalled = false;
+					if (w.func)
+						calls.emplace_back(w.func, std::make_pair(t, false));
+				}
+				continue;
+			}
+
+			// a thread that is slowed down (a low frame rate or the throttle) is given
+			// two of its iterations before it counts as stalled.
+			const auto limit = std::max(w.timeout, std::chrono::duration_cast<std::chrono::steady_clock::duration>(2 * t->getHeartbeatPeriod()));
+			if (!w.stalled && now - w.since > limit)
+			{
+				w.stalled = true;
+				w.nstalls++;
+				if (w.func)
+					calls.emplace_back(w.func, std::make_pair(t, true));
+			}
+		}
+	}
+
+	for (auto& c : calls)
+		c.first(c.second.first, c.second.second);
+}